@@ -0,0 +1,53 @@
+/**
+ * Fails if the designated allocation-free configuration allocates in steady state: a depth first policy_space_t
+ * search with the hashed closed set over a model whose states and successor lists own no heap memory.
+ * Only growing the frontier and the closed set may allocate, which is logarithmic in the number of states.
+ * Built and registered with ctest by cmake -DALLOC_TRACKING=ON.
+ */
+#include "policy_space.hpp"
+#include "alloc_tracker.hpp"
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+using cell_t = std::array<std::uint16_t,2>; // a position on a torus
+
+// Allocations of an exhaustive search of a torus of side x side cells
+std::size_t search_allocations(std::uint16_t side)
+{
+	auto neighbours = [side](const cell_t& cell){
+		return std::array<cell_t,4>{
+			cell_t{static_cast<std::uint16_t>((cell[0]+1)%side), cell[1]},
+			cell_t{static_cast<std::uint16_t>((cell[0]+side-1)%side), cell[1]},
+			cell_t{cell[0], static_cast<std::uint16_t>((cell[1]+1)%side)},
+			cell_t{cell[0], static_cast<std::uint16_t>((cell[1]+side-1)%side)}};
+	};
+	auto space = policy_space_t<cell_t, decltype(neighbours), lifo_frontier_t<cell_t>>{cell_t{}, neighbours};
+	auto statistics = search_statistics_t{};
+	auto counters = allocation_counters_t{};
+	{
+		scoped_allocation_counting_t counting{counters};
+		try {
+			space.check([](const cell_t&){ return false; }, statistics);
+		} catch (const std::logic_error* error) { // exhausted, as expected
+			delete error;
+		}
+	}
+	auto allocations = std::size_t{0};
+	for (auto count : counters.allocations)
+		allocations += count;
+	std::cout << statistics.expanded << " states expanded with " << allocations << " allocations\n";
+	return allocations;
+}
+
+int main()
+{
+	// 16 times the states: each container doubles 4 more times
+	auto small = search_allocations(64);
+	auto large = search_allocations(256);
+	if (large > small + 16) {
+		std::cerr << "Steady state allocates: " << large - small << " more allocations for 16 times the states\n";
+		return 1;
+	}
+}
@@ -0,0 +1,67 @@
+/**
+ * Replacement of the global allocation functions counting every allocation by phase (see alloc_tracker.hpp).
+ * Link into an executable to enable allocation accounting.
+ */
+#include "alloc_tracker.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifdef ALLOC_TRACKING
+
+void *operator new(std::size_t size)
+{
+    alloc_tracker::record(size);
+    if (auto memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    alloc_tracker::record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void *memory) noexcept
+{
+    if (memory)
+        alloc_tracker::record_release();
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept { operator delete(memory); }
+void operator delete(void *memory, std::size_t) noexcept { operator delete(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { operator delete(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { operator delete(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { operator delete(memory); }
+
+// Over-aligned types: aligned_alloc wants a multiple of the alignment, and its memory is released by free too
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    alloc_tracker::record(size);
+    auto align = static_cast<std::size_t>(alignment);
+    return std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (auto memory = operator new(size, alignment, std::nothrow))
+        return memory;
+    throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &tag) noexcept { return operator new(size, alignment, tag); }
+
+void operator delete(void *memory, std::align_val_t) noexcept { operator delete(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { operator delete(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { operator delete(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { operator delete(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept { operator delete(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept { operator delete(memory); }
+
+#endif //ALLOC_TRACKING
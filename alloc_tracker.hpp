@@ -0,0 +1,87 @@
+#include "statistics.hpp"
+#include <cstddef>
+
+#ifndef ALLOC_TRACKER_H // include guards
+#define ALLOC_TRACKER_H
+
+// Opt-in heap allocation accounting: compile with -DALLOC_TRACKING and link alloc_tracker.cpp,
+// which replaces the global operator new/delete (cmake -DALLOC_TRACKING=ON does both).
+// ALLOC_PHASE(phase) attributes the allocations of the calling thread to phase for the rest of the scope.
+// Each thread counts its own allocations (and the releases it makes), so concurrent searches do not count each other's.
+// Without ALLOC_TRACKING the macro expands to nothing and no counters are recorded.
+#ifdef ALLOC_TRACKING
+
+namespace alloc_tracker
+{
+    constexpr auto phases = static_cast<std::size_t>(alloc_phase_t::count);
+
+    inline thread_local alloc_phase_t current_phase = alloc_phase_t::other;
+    inline thread_local allocation_counters_t counters{};
+
+    inline void record(std::size_t size) noexcept
+    {
+        auto phase = static_cast<std::size_t>(current_phase);
+        ++counters.allocations[phase];
+        counters.bytes[phase] += size;
+    }
+
+    inline void record_release() noexcept { ++counters.deallocations[static_cast<std::size_t>(current_phase)]; }
+
+    // The counters of the calling thread
+    inline allocation_counters_t snapshot() noexcept { return counters; }
+
+    // Attributes allocations to a phase for its own lifetime, restoring the enclosing phase afterwards (RAII)
+    class scoped_phase_t
+    {
+    public:
+        explicit scoped_phase_t(alloc_phase_t phase) noexcept : enclosing{current_phase} { current_phase = phase; }
+        ~scoped_phase_t() { current_phase = enclosing; }
+        scoped_phase_t(const scoped_phase_t &) = delete;
+        scoped_phase_t &operator=(const scoped_phase_t &) = delete;
+
+    private:
+        alloc_phase_t enclosing;
+    };
+} // namespace alloc_tracker
+
+#define ALLOC_CONCAT_(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_(a, b)
+#define ALLOC_PHASE(phase) alloc_tracker::scoped_phase_t ALLOC_CONCAT(alloc_phase_, __LINE__) { phase }
+
+#else
+
+#define ALLOC_PHASE(phase) static_cast<void>(0)
+
+#endif //ALLOC_TRACKING
+
+// Records the allocations made by the calling thread during its own lifetime into the given counters (RAII)
+class scoped_allocation_counting_t
+{
+public:
+    explicit scoped_allocation_counting_t(allocation_counters_t &counters) noexcept : result{counters}
+    {
+#ifdef ALLOC_TRACKING
+        start = alloc_tracker::snapshot();
+#endif
+    }
+    ~scoped_allocation_counting_t()
+    {
+#ifdef ALLOC_TRACKING
+        auto end = alloc_tracker::snapshot();
+        for (auto i = 0u; i < alloc_tracker::phases; ++i)
+        {
+            result.allocations[i] = end.allocations[i] - start.allocations[i];
+            result.bytes[i] = end.bytes[i] - start.bytes[i];
+            result.deallocations[i] = end.deallocations[i] - start.deallocations[i];
+        }
+#endif
+    }
+    scoped_allocation_counting_t(const scoped_allocation_counting_t &) = delete;
+    scoped_allocation_counting_t &operator=(const scoped_allocation_counting_t &) = delete;
+
+private:
+    allocation_counters_t &result;
+    allocation_counters_t start{};
+};
+
+#endif //ALLOC_TRACKER_H
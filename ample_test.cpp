@@ -0,0 +1,86 @@
+/**
+ * Fails if the partial-order reduction of ample_successors hides a goal, or stops pruning.
+ * Variables are bytes of the state, variable i has footprint bit i.
+ */
+#include "reachability.hpp"
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using state_t = std::array<std::uint8_t,3>;
+
+constexpr std::uint64_t bit(int variable) { return std::uint64_t{1} << variable; }
+
+int failures = 0;
+
+void expect(bool passed, const char* what)
+{
+	if (!passed) {
+		std::cerr << "FAILED: " << what << '\n';
+		++failures;
+	}
+}
+
+// t1 sets x, t2 sets y and t3 sets z only while x is unset and y is set. The goal reads z. Pruning t2 after t1 would
+// be sound among the enabled transitions, but t2 enables t3 and t1 disables it.
+std::vector<transition_t<state_t>> enabling(const state_t&)
+{
+	return {
+		{[](state_t& s){ s[0] = 1; }, {0, bit(0)}},
+		{[](state_t& s){ s[1] = 1; }, {0, bit(1)}},
+		{[](state_t& s){ s[2] = 1; }, {bit(0) | bit(1), bit(2)}, [](const state_t& s){ return s[0] == 0 && s[1] == 1; }}};
+}
+
+// Three independent counters up to 3, the goal reads the first one: the others are counted up one at a time
+std::vector<transition_t<state_t>> counters(const state_t&)
+{
+	auto transitions = std::vector<transition_t<state_t>>{};
+	for (auto i = 0; i < 3; ++i)
+		transitions.push_back({[i](state_t& s){ ++s[i]; }, {bit(i), bit(i)}, [i](const state_t& s){ return s[i] < 3; }});
+	return transitions;
+}
+
+// The solution and statistics of a search, an empty solution if it exhausted the space
+template <typename Successor_gen>
+std::list<state_t> search(const Successor_gen& successors, bool (*goal)(const state_t&), search_order_t order, search_statistics_t& statistics)
+{
+	auto space = state_space_t{state_t{}, successors};
+	return space.check(goal, order, cancellation_token_t{}, statistics).solution;
+}
+
+// A path of enabled transitions
+bool connected(const std::list<state_t>& path, std::vector<transition_t<state_t>> (*transitions)(const state_t&))
+{
+	for (auto state = path.begin(); std::next(state) != path.end(); ++state) {
+		auto succs = successors<state_t>(transitions)(*state);
+		if (std::find(succs.begin(), succs.end(), *std::next(state)) == succs.end())
+			return false;
+	}
+	return true;
+}
+
+int main()
+{
+	auto z_set = [](const state_t& s){ return s[2] == 1; };
+	auto x_full = [](const state_t& s){ return s[0] == 3; };
+	auto never = [](const state_t& s){ return s[0] == 4; };
+	for (auto order : {search_order_t::breadth_first, search_order_t::depth_first}) {
+		auto full = search_statistics_t{}, reduced = search_statistics_t{};
+
+		auto expected = search(successors<state_t>(enabling), z_set, order, full);
+		auto solution = search(ample_successors<state_t>(enabling, bit(2)), z_set, order, reduced);
+		expect(expected.size() == 3, "the full search reaches z through y");
+		expect(solution == expected, "the reduction keeps the transition enabling the goal");
+
+		solution = search(ample_successors<state_t>(counters, bit(0)), x_full, order, reduced);
+		expect(!solution.empty() && x_full(solution.back()) && connected(solution, counters), "the reduced search reaches the goal");
+
+		search(successors<state_t>(counters), never, order, full);
+		search(ample_successors<state_t>(counters, bit(0)), never, order, reduced);
+		expect(full.expanded == 64, "the full search expands every state");
+		expect(reduced.expanded == 10, "the reduced search expands one interleaving");
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+/**
+ * Fails if anytime cost guided search misses a cheaper path to a goal it has already reached.
+ * The graph 0->{1,2}, 1->8->3, 2->9->3 with additive weights reaches the goal 3 first by 0 1 8 3 (cost 5),
+ * the optimum is 0 2 9 3 (cost 4), through a state that is already stored when it is found.
+ */
+#include "reachability.hpp"
+#include <iostream>
+#include <list>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+const auto edges = std::map<int, std::vector<int>>{{0, {1, 2}}, {1, {8}}, {2, {9}}, {8, {3}}, {9, {3}}, {3, {}}};
+const auto weights = std::map<int, int>{{0, 0}, {1, 2}, {2, 4}, {8, 3}, {9, 0}, {3, 0}};
+
+int failures = 0;
+
+void expect(bool passed, const char* what)
+{
+	if (!passed) {
+		std::cerr << "FAILED: " << what << '\n';
+		++failures;
+	}
+}
+
+int main()
+{
+	auto space = state_space_t{0, 0, [](const int& node){ return std::list<int>(edges.at(node).begin(), edges.at(node).end()); },
+		[](const int&){ return true; },
+		[](const int& node, const int& prev_cost){ return prev_cost + weights.at(node); }};
+	auto goal = [](const int& node){ return node == 3; };
+	auto optimum = std::list<int>{0, 2, 9, 3};
+
+	auto result = space.check(goal, search_order_t::cost_guided, cancellation_token_t{});
+	expect(result.status == search_status_t::solved, "anytime search solves");
+	expect(result.solution == optimum, "anytime search finds the cheaper path to the reached goal");
+
+	// The same over the cached graph, which a query with a token searches only once it is built
+	space.cache_graph();
+	space.graph();
+	auto statistics = search_statistics_t{};
+	result = space.check(goal, search_order_t::cost_guided, cancellation_token_t{}, statistics);
+	expect(statistics.bytes_per_state == sizeof(std::size_t), "anytime search runs over the cached graph");
+	expect(result.solution == optimum, "anytime search over the cached graph finds the cheaper path");
+
+	auto shortest = space.check_k_shortest(goal, 1, search_order_t::cost_guided);
+	expect(!shortest.empty() && shortest.front() == optimum, "the cheapest path agrees with check_k_shortest");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/**
+ * Benchmark suite over all models and search orders.
+ * Every case runs in a forked child (so that peak RSS is per case) for a number of trials,
+ * with hardware event counters where perf_event_open is available,
+ * and is reported as one JSON object per line on stdout. Trials that throw are counted as failed and left out of
+ * the timings and statistics, a case without a successful trial reports no timings.
+ * The batch kernels over the states of each model follow, also one JSON object per line.
+ * Usage: ./bench [trials=10] [max_frogs=4]
+ */
+#include "bench.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Runs the trials of one case in the current process and prints its report line
+void run_case(const bench_case_t &bench, std::size_t trials, std::ostream &out)
+{
+    // A trial that throws has no statistics of its own: it is counted as failed and left out of the timings
+    std::vector<double> times{};
+    search_statistics_t statistics{};
+    std::size_t failed = 0;
+    for (auto trial = 0u; trial < trials; ++trial)
+    {
+        try
+        {
+            statistics = bench.run();
+            times.push_back(std::chrono::duration<double, std::nano>(statistics.time.total).count());
+        }
+        catch (std::exception *error) // check reports a missing solution by throwing a pointer
+        {
+            delete error;
+            ++failed;
+        }
+    }
+    out << "{\"model\":\"" << bench.model << "\",\"size\":" << bench.size
+        << ",\"order\":\"" << to_string(bench.order) << "\",\"trials\":" << trials
+        << ",\"failed\":" << failed;
+    if (times.empty())
+    {
+        out << "}" << std::endl;
+        return;
+    }
+    std::sort(times.begin(), times.end());
+    auto median = times[times.size() / 2];
+    auto p95 = times[std::min(times.size() - 1, (times.size() * 95 + 99) / 100 - 1)];
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    out << ",\"median_ns\":" << static_cast<long long>(median)
+        << ",\"p95_ns\":" << static_cast<long long>(p95)
+        << ",\"states\":" << statistics.expanded
+        << ",\"states_per_sec\":" << static_cast<long long>(median > 0 ? statistics.expanded * 1e9 / median : 0)
+        << ",\"peak_rss_kb\":" << usage.ru_maxrss
+        << ",\"statistics\":" << statistics << "}" << std::endl;
+}
+
+// Runs the trials of one kernel case and prints its report line
+void run_kernel(const kernel_case_t &bench, std::size_t trials, std::ostream &out)
+{
+    std::vector<double> times{};
+    for (auto trial = 0u; trial < trials; ++trial)
+        times.push_back(bench.run());
+    std::sort(times.begin(), times.end());
+    out << "{\"model\":\"" << bench.model << "\",\"kernel\":\"" << bench.kernel
+        << "\",\"avx2\":" << (batch_avx2() ? "true" : "false") << ",\"trials\":" << trials
+        << ",\"median_ns_per_state\":" << times[times.size() / 2] << "}" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    const std::size_t trials = argc > 1 ? std::max(1l, std::atol(argv[1])) : 10;
+    const std::size_t max_frogs = argc > 2 ? std::atol(argv[2]) : 4;
+    std::vector<bench_case_t> cases = frogs_cases(max_frogs);
+    for (auto &&more : {crossing_cases(), family_cases()})
+        cases.insert(cases.end(), more.begin(), more.end());
+
+    // The models log to std::cout, so the report keeps the real buffer and the models get none
+    std::ostream out{std::cout.rdbuf()};
+    std::cout.rdbuf(nullptr);
+    for (auto &bench : cases)
+    {
+        out.flush();
+        auto child = fork();
+        if (child == 0)
+        {
+            run_case(bench, trials, out);
+            std::_Exit(0);
+        }
+        int status = 0;
+        if (child < 0 || waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            std::cerr << "bench: " << bench.model << " " << bench.size << " " << to_string(bench.order) << " failed\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::vector<kernel_case_t> kernels = frogs_kernels(max_frogs);
+    for (auto &&more : {crossing_kernels(), family_kernels()})
+        kernels.insert(kernels.end(), more.begin(), more.end());
+    for (auto &kernel : kernels)
+        run_kernel(kernel, trials, out);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+#include "reachability.hpp"
+#include "state_batch.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_H // include guards
+#define BENCH_H
+
+// One benchmark: a model instance searched in one order, returning the statistics of a single search
+struct bench_case_t
+{
+    std::string model;
+    std::size_t size;
+    search_order_t order;
+    std::function<search_statistics_t()> run;
+};
+
+// One kernel benchmark: a kernel over the reachable states of a model, returning nanoseconds per state of a single run
+struct kernel_case_t
+{
+    std::string model;
+    std::string kernel;
+    std::function<double()> run;
+};
+
+constexpr search_order_t all_search_orders[] = {search_order_t::depth_first, search_order_t::breadth_first, search_order_t::cost_guided};
+
+inline const char *to_string(search_order_t order)
+{
+    switch (order)
+    {
+    case search_order_t::depth_first:
+        return "depth_first";
+    case search_order_t::breadth_first:
+        return "breadth_first";
+    case search_order_t::cost_guided:
+        return "cost_guided";
+    }
+    return "unknown";
+}
+
+// The batch hashing of state_batch.hpp against a state_hash loop over the same states
+template <typename State_t>
+std::vector<kernel_case_t> kernel_cases(const std::string &model, std::vector<State_t> reachable)
+{
+    auto states = std::make_shared<const std::vector<State_t>>(std::move(reachable));
+    auto pointers = std::make_shared<std::vector<const State_t *>>();
+    for (auto &state : *states)
+        pointers->push_back(&state);
+    auto hashes = std::make_shared<std::vector<std::uint64_t>>(states->size());
+    auto rounds = std::max<std::size_t>(1, (std::size_t{1} << 20) / states->size());
+    auto per_state = [states, hashes, rounds](auto &&kernel) {
+        static volatile std::uint64_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (auto round = 0u; round < rounds; ++round)
+        {
+            kernel();
+            sink = sink + hashes->back();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (rounds * states->size());
+    };
+    return {
+        {model, "state_hashes", [=] { return per_state([&] { state_hashes(pointers->data(), pointers->size(), hashes->data()); }); }},
+        {model, "state_hash", [=] {
+             return per_state([&] {
+                 for (auto i = 0u; i < states->size(); ++i)
+                     (*hashes)[i] = state_hash((*states)[i]);
+             });
+         }},
+    };
+}
+
+// Each model registers its cases from its own translation unit, as the models overload the same names
+std::vector<bench_case_t> frogs_cases(std::size_t max_frogs);
+std::vector<bench_case_t> crossing_cases();
+std::vector<bench_case_t> family_cases();
+std::vector<kernel_case_t> frogs_kernels(std::size_t frogs);
+std::vector<kernel_case_t> crossing_kernels();
+std::vector<kernel_case_t> family_kernels();
+
+#endif //BENCH_H
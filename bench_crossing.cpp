@@ -0,0 +1,32 @@
+#include "bench.hpp"
+#include "crossing.hpp"
+#include "policy_space.hpp"
+
+std::vector<bench_case_t> crossing_cases()
+{
+	auto cases = std::vector<bench_case_t>{};
+	auto goal = [](const actors_t& actors){
+		return std::count(std::begin(actors), std::end(actors), pos_t::shore2)==static_cast<long>(actors.size());
+	};
+	for (auto order : all_search_orders) {
+		cases.push_back({"crossing", 3, order, [order, goal]{
+			auto space = state_space_t{actors_t{}, successors<actors_t>(transitions), &is_valid};
+			space.count_hardware_events();
+			auto statistics = search_statistics_t{};
+			space.check(goal, order, statistics);
+			return statistics;
+		}});
+		cases.push_back({"crossing_static", 3, order, [order, goal]{
+			auto statistics = search_statistics_t{};
+			check_static(actors_t{}, successors<actors_t>(transitions), &is_valid, goal, order, statistics);
+			return statistics;
+		}});
+	}
+	return cases;
+}
+
+std::vector<kernel_case_t> crossing_kernels()
+{
+	auto space = state_space_t{actors_t{}, successors<actors_t>(transitions), &is_valid};
+	return kernel_cases("crossing", space.graph()->states);
+}
@@ -0,0 +1,24 @@
+#include "bench.hpp"
+#include "family.hpp"
+
+std::vector<bench_case_t> family_cases()
+{
+	auto cases = std::vector<bench_case_t>{};
+	for (auto order : all_search_orders)
+		cases.push_back({"family", 8, order, [order]{
+			auto space = state_space_t{
+				state_t{}, cost_t{}, successors<state_t>(transitions), &river_crossing_valid,
+				[](const state_t&, const cost_t& prev_cost){ return cost_t{ prev_cost.depth+1, prev_cost.noise }; }};
+			space.count_hardware_events();
+			auto statistics = search_statistics_t{};
+			space.check(&goal, order, statistics);
+			return statistics;
+		}});
+	return cases;
+}
+
+std::vector<kernel_case_t> family_kernels()
+{
+	auto space = state_space_t{state_t{}, successors<state_t>(transitions), &river_crossing_valid};
+	return kernel_cases("family", space.graph()->states);
+}
@@ -0,0 +1,34 @@
+#include "bench.hpp"
+#include "frogs.hpp"
+#include "policy_space.hpp"
+
+std::vector<bench_case_t> frogs_cases(std::size_t max_frogs)
+{
+	auto cases = std::vector<bench_case_t>{};
+	for (auto frogs = 1u; frogs <= max_frogs; ++frogs)
+		for (auto order : all_search_orders) {
+			cases.push_back({"frogs", frogs, order, [frogs, order]{
+				auto [start, finish] = puzzle(frogs);
+				auto space = state_space_t{start, successors<stones_t>(transitions)};
+				space.count_hardware_events();
+				auto statistics = search_statistics_t{};
+				space.check([&finish](const stones_t& state){ return state==finish; }, order, statistics);
+				return statistics;
+			}});
+			// The plain search with the order, invariant and goal fixed at compile time (policy_space.hpp)
+			cases.push_back({"frogs_static", frogs, order, [frogs, order]{
+				auto [start, finish] = puzzle(frogs);
+				auto statistics = search_statistics_t{};
+				check_static(start, successors<stones_t>(transitions), no_invariant_t{},
+							 [&finish](const stones_t& state){ return state==finish; }, order, statistics);
+				return statistics;
+			}});
+		}
+	return cases;
+}
+
+std::vector<kernel_case_t> frogs_kernels(std::size_t frogs)
+{
+	auto space = state_space_t{puzzle(frogs).first, successors<stones_t>(transitions)};
+	return kernel_cases("frogs", space.graph()->states);
+}
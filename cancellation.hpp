@@ -0,0 +1,31 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#ifndef CANCELLATION_H // include guards
+#define CANCELLATION_H
+
+// Cooperative cancellation of a search: cancelled on request (from any thread, by any copy of the token) or at a deadline
+class cancellation_token_t
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    cancellation_token_t() = default;
+    explicit cancellation_token_t(clock::time_point deadline) noexcept : deadline{deadline} {}
+    explicit cancellation_token_t(clock::duration timeout) noexcept : deadline{clock::now() + timeout} {}
+
+    void cancel() noexcept { cancelled->store(true, std::memory_order_relaxed); }
+
+    // Cheap check of the cancel flag only
+    bool cancel_requested() const noexcept { return cancelled->load(std::memory_order_relaxed); }
+
+    // Checks the cancel flag and the deadline (reads the clock)
+    bool expired() const noexcept { return cancel_requested() || clock::now() >= deadline; }
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+    clock::time_point deadline = clock::time_point::max();
+};
+
+#endif //CANCELLATION_H
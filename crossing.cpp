@@ -6,62 +6,13 @@
  */
 
 #include "reachability.hpp" // your header-only library solution
+#include "crossing.hpp" // model of the puzzle
+#include "solution_cache.hpp" // solutions kept between runs
 #include <functional> // std::function
 #include <list>
 #include <array>
 #include <iostream>
-
-enum actor { cabbage, goat, wolf }; // names of the actors
-enum class pos_t { shore1, travel, shore2}; // names of the actor positions
-using actors_t = std::array<pos_t,3>; // positions of the actors
-
-std::ostream& operator<<(std::ostream& stream, actors_t state)
-{
-	for (auto& position : state)
-	{
-		if(position == pos_t::shore1)
-			stream << "1";
-		if(position == pos_t::shore2)
-			stream << "2";
-		if(position == pos_t::travel)
-			stream << "~";			
-	}
-	stream << std::endl;
-	return stream;
-}
-
-
-auto transitions(const actors_t& actors)
-{
-	auto res = std::list<std::function<void(actors_t&)>>{};
-	for (auto i=0u; i<actors.size(); ++i)
-		switch(actors[i]) {
-		case pos_t::shore1:
-			res.push_back([i](actors_t& actors){ actors[i] = pos_t::travel; });
-			break;
-		case pos_t::travel:
-			res.push_back([i](actors_t& actors){ actors[i] = pos_t::shore1; });
-			res.push_back([i](actors_t& actors){ actors[i] = pos_t::shore2; });
-			break;
-		case pos_t::shore2:
-			res.push_back([i](actors_t& actors){ actors[i] = pos_t::travel; });
-			break;
-		}
-	return res;
-}
-
-bool is_valid(const actors_t& actors) {
-	// only one passenger:
-	if (std::count(std::begin(actors), std::end(actors), pos_t::travel)>1)
-		return false;
-	// goat cannot be left alone with wolf, as wolf will eat the goat:
-	if (actors[actor::goat]==actors[actor::wolf] && actors[actor::cabbage]==pos_t::travel)
-		return false;
-	// goat cannot be left alone with cabbage, as goat will eat the cabbage:
-	if (actors[actor::goat]==actors[actor::cabbage] && actors[actor::wolf]==pos_t::travel)
-		return false;
-	return true;
-}
+#include <filesystem>
 
 void solve(){
 	auto state_space = state_space_t{
@@ -78,8 +29,25 @@ void solve(){
 		std::cout << i++ << ": " << trace;
 }
 
+void solve_cached(){
+	// Repeated queries are answered from a cache file, which outlives the process
+	auto path = (std::filesystem::temp_directory_path() / "crossing.cache").string();
+	auto goal = [](const actors_t& actors){
+		return std::count(std::begin(actors), std::end(actors), pos_t::shore2)==static_cast<long>(actors.size());
+	};
+	for (auto run = 0; run < 2; ++run) {
+		auto state_space = state_space_t{actors_t{}, successors<actors_t>(transitions), &is_valid};
+		auto cache = solution_cache_t<actors_t>{path, "crossing", "1"};
+		auto cached = cache.size();
+		auto solution = cache.check(state_space, goal, "all on shore2");
+		std::cout << "Run " << run << ": " << cached << " cached solutions, found a trace of " << solution.size() << " states\n";
+	}
+	std::filesystem::remove(path);
+}
+
 int main(){
 	solve();
+	solve_cached();
 }
 
 /** Sample output:
@@ -0,0 +1,67 @@
+/**
+ * Model for goat, cabbage and wolf puzzle.
+ * Author: Marius Mikucionis <marius@cs.aau.dk>
+ */
+#include "reachability.hpp"
+#include <functional> // std::function
+#include <list>
+#include <array>
+#include <algorithm>
+#include <iostream>
+
+#ifndef CROSSING_H // include guards
+#define CROSSING_H
+
+enum actor { cabbage, goat, wolf }; // names of the actors
+enum class pos_t { shore1, travel, shore2}; // names of the actor positions
+using actors_t = std::array<pos_t,3>; // positions of the actors
+
+inline std::ostream& operator<<(std::ostream& stream, actors_t state)
+{
+	for (auto& position : state)
+	{
+		if(position == pos_t::shore1)
+			stream << "1";
+		if(position == pos_t::shore2)
+			stream << "2";
+		if(position == pos_t::travel)
+			stream << "~";			
+	}
+	stream << std::endl;
+	return stream;
+}
+
+
+inline auto transitions(const actors_t& actors)
+{
+	auto res = std::list<std::function<void(actors_t&)>>{};
+	for (auto i=0u; i<actors.size(); ++i)
+		switch(actors[i]) {
+		case pos_t::shore1:
+			res.push_back([i](actors_t& actors){ actors[i] = pos_t::travel; });
+			break;
+		case pos_t::travel:
+			res.push_back([i](actors_t& actors){ actors[i] = pos_t::shore1; });
+			res.push_back([i](actors_t& actors){ actors[i] = pos_t::shore2; });
+			break;
+		case pos_t::shore2:
+			res.push_back([i](actors_t& actors){ actors[i] = pos_t::travel; });
+			break;
+		}
+	return res;
+}
+
+inline bool is_valid(const actors_t& actors) {
+	// only one passenger:
+	if (std::count(std::begin(actors), std::end(actors), pos_t::travel)>1)
+		return false;
+	// goat cannot be left alone with wolf, as wolf will eat the goat:
+	if (actors[actor::goat]==actors[actor::wolf] && actors[actor::cabbage]==pos_t::travel)
+		return false;
+	// goat cannot be left alone with cabbage, as goat will eat the cabbage:
+	if (actors[actor::goat]==actors[actor::cabbage] && actors[actor::wolf]==pos_t::travel)
+		return false;
+	return true;
+}
+
+#endif //CROSSING_H
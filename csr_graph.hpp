@@ -0,0 +1,211 @@
+#include "reachability.hpp"
+#include "state_codec.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef CSR_GRAPH_H // include guards
+#define CSR_GRAPH_H
+
+// Layout of a graph file, in native byte order: the header, the edge offsets (states + 1 entries), the successor indices
+// (padded to 8 bytes), the state offsets (states + 1 entries) and the packed states
+struct csr_header_t
+{
+    char magic[8]{'P', 'Z', 'L', 'C', 'S', 'R', '0', '1'};
+    std::uint64_t states{0};
+    std::uint64_t edges{0};
+    std::uint64_t state_bytes{0}; // of all packed states
+    std::uint64_t state_size{0};  // sizeof the state type, to catch files of other models
+};
+
+// Writes the graph in compressed sparse row form, section by section straight from the graph without copying it
+template <typename State_t>
+void write_csr(std::ostream &out, const state_graph_t<State_t> &graph)
+{
+    using codec = state_codec<State_t>;
+    if (graph.states.size() > std::numeric_limits<std::uint32_t>::max())
+        throw new std::length_error("The state graph is too large for the graph file format");
+    csr_header_t header{};
+    header.states = graph.states.size();
+    header.state_size = sizeof(State_t);
+    for (auto i = 0u; i < graph.states.size(); ++i)
+    {
+        header.edges += graph.edges[i].size();
+        header.state_bytes += codec::size(graph.states[i]);
+    }
+    auto write_word = [&out](auto word) { out.write(reinterpret_cast<const char *>(&word), sizeof(word)); };
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    std::uint64_t offset = 0;
+    write_word(offset);
+    for (auto &edges : graph.edges)
+        write_word(offset += edges.size());
+    for (auto &edges : graph.edges)
+        for (auto target : edges)
+            write_word(static_cast<std::uint32_t>(target));
+    if (header.edges % 2 != 0)
+        write_word(std::uint32_t{0});
+    offset = 0;
+    write_word(offset);
+    for (auto &state : graph.states)
+        write_word(offset += codec::size(state));
+    for (auto &state : graph.states)
+        codec::write(out, state);
+    if (!out)
+        throw new std::runtime_error("The state graph could not be written");
+}
+
+template <typename State_t>
+void write_csr(const std::string &path, const state_graph_t<State_t> &graph)
+{
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    write_csr(out, graph);
+}
+
+// A graph file mapped into memory: successors are read in place, states are unpacked on access. It has the graph interface
+// of state_graph_t, so state_space_t::check_graph and explore_graph search it without loading it.
+template <typename State_t>
+class csr_graph_t
+{
+public:
+    // Successor indices of one state
+    struct successors_t
+    {
+        const std::uint32_t *first;
+        const std::uint32_t *last;
+        const std::uint32_t *begin() const noexcept { return first; }
+        const std::uint32_t *end() const noexcept { return last; }
+        std::size_t size() const noexcept { return last - first; }
+        bool empty() const noexcept { return first == last; }
+    };
+
+    explicit csr_graph_t(const std::string &path)
+    {
+#if defined(__unix__)
+        auto file = ::open(path.c_str(), O_RDONLY);
+        struct stat status{};
+        if (file < 0 || ::fstat(file, &status) != 0)
+        {
+            if (file >= 0)
+                ::close(file);
+            throw new std::runtime_error("The graph file " + path + " could not be opened");
+        }
+        length = static_cast<std::size_t>(status.st_size);
+        void *mapped = length > 0 ? ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+        ::close(file);
+        if (mapped == MAP_FAILED)
+            throw new std::runtime_error("The graph file " + path + " could not be mapped");
+        bytes = static_cast<const char *>(mapped);
+#else
+        std::ifstream in{path, std::ios::binary};
+        if (!in)
+            throw new std::runtime_error("The graph file " + path + " could not be opened");
+        buffer.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+        bytes = buffer.data();
+        length = buffer.size();
+#endif
+        if (!valid())
+        {
+            release();
+            throw new std::runtime_error("The graph file " + path + " is corrupt or not a graph of this state type");
+        }
+    }
+
+    ~csr_graph_t() { release(); }
+
+    csr_graph_t(const csr_graph_t &) = delete;
+    csr_graph_t &operator=(const csr_graph_t &) = delete;
+
+    std::size_t size() const noexcept { return header.states; }
+    std::size_t edge_count() const noexcept { return header.edges; }
+
+    // State 0 is the initial state
+    State_t state(std::size_t index) const
+    {
+        return state_codec<State_t>::read(packed + state_offsets[index], state_offsets[index + 1] - state_offsets[index]);
+    }
+
+    successors_t successors(std::size_t index) const noexcept { return {targets + edge_offsets[index], targets + edge_offsets[index + 1]}; }
+
+    // Unpacks and copies the whole graph, e.g. for state_space_t::use_graph: time and memory in the size of the graph
+    state_graph_t<State_t> to_state_graph() const
+    {
+        state_graph_t<State_t> graph{};
+        graph.states.reserve(size());
+        graph.edges.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            graph.states.push_back(state(i));
+            auto succs = successors(i);
+            graph.edges.emplace_back(succs.begin(), succs.end());
+        }
+        return graph;
+    }
+
+private:
+    // Checks the header, that every section lies within the file and that the offsets and targets stay within their
+    // sections, and locates the sections. Unpacking a state checks its size (see state_codec).
+    bool valid() noexcept
+    {
+        if (length < sizeof(csr_header_t))
+            return false;
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.magic, csr_header_t{}.magic, sizeof(header.magic)) != 0 || header.state_size != sizeof(State_t) ||
+            header.states == 0 || header.states > std::numeric_limits<std::uint32_t>::max())
+            return false;
+        auto targets_at = sizeof(csr_header_t) + (header.states + 1) * sizeof(std::uint64_t);
+        auto state_offsets_at = targets_at + (header.edges + header.edges % 2) * sizeof(std::uint32_t);
+        auto packed_at = state_offsets_at + (header.states + 1) * sizeof(std::uint64_t);
+        if (header.edges > length || header.state_bytes > length || packed_at + header.state_bytes != length)
+            return false;
+        edge_offsets = reinterpret_cast<const std::uint64_t *>(bytes + sizeof(csr_header_t));
+        targets = reinterpret_cast<const std::uint32_t *>(bytes + targets_at);
+        state_offsets = reinterpret_cast<const std::uint64_t *>(bytes + state_offsets_at);
+        packed = bytes + packed_at;
+        if (edge_offsets[0] != 0 || state_offsets[0] != 0)
+            return false;
+        for (std::uint64_t i = 0; i < header.states; ++i)
+            if (edge_offsets[i + 1] < edge_offsets[i] || state_offsets[i + 1] < state_offsets[i])
+                return false;
+        if (edge_offsets[header.states] != header.edges || state_offsets[header.states] != header.state_bytes)
+            return false;
+        return std::all_of(targets, targets + header.edges, [this](std::uint32_t target) { return target < header.states; });
+    }
+
+    void release() noexcept
+    {
+#if defined(__unix__)
+        if (bytes)
+            ::munmap(const_cast<char *>(bytes), length);
+#endif
+        bytes = nullptr;
+    }
+
+    const char *bytes{nullptr};
+    std::size_t length{0};
+#if !defined(__unix__)
+    std::vector<char> buffer{};
+#endif
+    csr_header_t header{};
+    const std::uint64_t *edge_offsets{nullptr};
+    const std::uint32_t *targets{nullptr};
+    const std::uint64_t *state_offsets{nullptr};
+    const char *packed{nullptr};
+};
+
+#endif //CSR_GRAPH_H
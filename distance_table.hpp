@@ -0,0 +1,98 @@
+#include "state_hash.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef DISTANCE_TABLE_H // include guards
+#define DISTANCE_TABLE_H
+
+// Distance to the nearest goal state of every state that can reach one, keyed by state fingerprint (see state_hash).
+// Sorted arrays of 12 bytes per state, looked up by binary search. Built by state_space_t::goal_distances.
+template <typename State_t>
+class distance_table_t
+{
+public:
+    using fingerprint_t = std::uint64_t;
+
+    distance_table_t() = default;
+
+    // Takes unordered (fingerprint, distance) entries
+    explicit distance_table_t(std::vector<std::pair<fingerprint_t, std::uint32_t>> entries)
+    {
+        std::sort(entries.begin(), entries.end());
+        fingerprints.reserve(entries.size());
+        distances.reserve(entries.size());
+        for (auto &[fingerprint, distance] : entries)
+        {
+            fingerprints.push_back(fingerprint);
+            distances.push_back(distance);
+        }
+    }
+
+    std::size_t size() const noexcept { return fingerprints.size(); }
+
+    // Steps from the state to the nearest goal, none if no goal can be reached from it
+    std::optional<std::uint32_t> distance(const State_t &state) const noexcept
+    {
+        auto fingerprint = state_hash(state);
+        auto found = std::lower_bound(fingerprints.begin(), fingerprints.end(), fingerprint);
+        if (found == fingerprints.end() || *found != fingerprint)
+            return std::nullopt;
+        return distances[found - fingerprints.begin()];
+    }
+
+    void save(const std::string &path) const
+    {
+        std::ofstream out{path, std::ios::binary | std::ios::trunc};
+        std::uint64_t count = size();
+        out.write(magic, sizeof(magic));
+        out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char *>(fingerprints.data()), count * sizeof(fingerprint_t));
+        out.write(reinterpret_cast<const char *>(distances.data()), count * sizeof(std::uint32_t));
+        if (!out)
+            throw new std::runtime_error("The distance table could not be written to " + path);
+    }
+
+    static distance_table_t load(const std::string &path)
+    {
+        std::ifstream in{path, std::ios::binary | std::ios::ate};
+        if (!in)
+            throw new std::runtime_error("The distance table " + path + " could not be opened");
+        auto bytes = static_cast<std::uint64_t>(in.tellg());
+        in.seekg(0);
+        char header[sizeof(magic)]{};
+        std::uint64_t count = 0;
+        in.read(header, sizeof(header));
+        in.read(reinterpret_cast<char *>(&count), sizeof(count));
+        if (!in || std::memcmp(header, magic, sizeof(magic)) != 0)
+            throw new std::runtime_error("The file " + path + " is not a distance table");
+        // The count is checked against the file before anything is allocated for it
+        constexpr auto entry_bytes = sizeof(fingerprint_t) + sizeof(std::uint32_t);
+        auto data_bytes = bytes - sizeof(magic) - sizeof(count);
+        if (count > data_bytes / entry_bytes || count * entry_bytes != data_bytes)
+            throw new std::runtime_error("The distance table " + path + " is truncated or corrupt");
+        distance_table_t table{};
+        table.fingerprints.resize(count);
+        table.distances.resize(count);
+        in.read(reinterpret_cast<char *>(table.fingerprints.data()), count * sizeof(fingerprint_t));
+        in.read(reinterpret_cast<char *>(table.distances.data()), count * sizeof(std::uint32_t));
+        if (!in || !std::is_sorted(table.fingerprints.begin(), table.fingerprints.end()))
+            throw new std::runtime_error("The distance table " + path + " is truncated or corrupt");
+        return table;
+    }
+
+private:
+    static constexpr char magic[8]{'P', 'Z', 'L', 'D', 'I', 'S', '0', '1'};
+
+    std::vector<fingerprint_t> fingerprints{};
+    std::vector<std::uint32_t> distances{};
+};
+
+#endif //DISTANCE_TABLE_H
@@ -0,0 +1,233 @@
+/**
+ * Model for Japanese family river crossing puzzle:
+ * https://www.funzug.com/index.php/flash-games/japanese-river-crossing-puzzle-game.html
+ * Author: Marius Mikucionis <marius@cs.aau.dk>
+ */
+#include "reachability.hpp"
+#include <iostream>
+#include <deque>
+#include <array>
+#include <algorithm>
+#include <functional> // std::function
+
+#ifndef FAMILY_H // include guards
+#define FAMILY_H
+
+/** Model of the river crossing: persons and a boat */
+struct person_t
+{
+	enum { shore1, onboard, shore2 } pos = shore1;
+	enum { mother, father, daughter1, daughter2, son1, son2, policeman, prisoner };
+};
+
+/** Model of a boat */
+struct boat_t
+{
+	enum { shore1, travel, shore2 } pos = shore1;
+	uint16_t capacity{2};
+	uint16_t passengers{0};
+};
+
+/** Model of an entire system */
+struct state_t
+{
+	boat_t boat;
+	std::array<person_t,8> persons;
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const person_t &person)
+{
+	if(person.pos == person_t::shore1)
+		stream << "{SH1}";
+	else if(person.pos == person_t::shore2)
+		stream << "{SH2}";
+	else if(person.pos == person_t::onboard)
+		stream << "{~~~}";
+	return stream;
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const boat_t &boat)
+{
+	if(boat.pos == boat_t::shore1)
+		stream << "{sh1," << boat.passengers << "," << boat.capacity << "}";
+	else if(boat.pos == boat_t::shore2)
+		stream << "{sh2," << boat.passengers << "," << boat.capacity << "}";
+	else if(boat.pos == boat_t::travel)
+		stream << "{trv," << boat.passengers << "," << boat.capacity << "}";
+	return stream;
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const state_t &state)
+{
+	stream << state.boat;
+	for(auto person : state.persons)
+		stream << person;
+	return stream << std::endl;	
+}
+
+/** Returns a list of transitions applicable on a given state.
+ * Transition is a function modifying a state */
+inline auto transitions(const state_t& s)
+{
+	auto res = std::deque<std::function<void(state_t&)>>{};
+	switch (s.boat.pos) {
+	case boat_t::shore1:
+	case boat_t::shore2:
+		if (s.boat.passengers>0) // start traveling
+			res.push_back([](state_t& state){ state.boat.pos = boat_t::travel; });
+		break;
+	case boat_t::travel:
+		res.push_back([](state_t& state){ // arrive to shore1
+							 state.boat.pos = boat_t::shore1;
+							 state.boat.passengers = 0;
+							 for (auto& p: state.persons)
+								 if (p.pos == person_t::onboard)
+									 p.pos = person_t::shore1;
+						 });
+		res.push_back([](state_t& state){	// arrive to shore2
+							 state.boat.pos = boat_t::shore2;
+							 state.boat.passengers = 0;
+							 for (auto& p: state.persons)
+								 if (p.pos == person_t::onboard)
+									 p.pos = person_t::shore2;
+						 });
+		break;
+	}
+	for (auto i=0u; i<s.persons.size(); ++i) {
+		switch (s.persons[i].pos) {
+		case person_t::shore1:  // board the boat on shore1:
+			if (s.boat.pos == boat_t::shore1)
+				res.push_back([i](state_t& state){
+								  state.persons[i].pos = person_t::onboard;
+								  ++state.boat.passengers;
+							  });
+			break;
+		case person_t::shore2: // board the boat on shore2:
+			if (s.boat.pos == boat_t::shore2)
+				res.push_back([i](state_t& state){
+								  state.persons[i].pos = person_t::onboard;
+								  ++state.boat.passengers;
+							  });
+			break;
+		case person_t::onboard:
+			if (s.boat.pos == boat_t::shore1) // leave the boat to shore1
+				res.push_back([i](state_t& state){
+								  state.persons[i].pos = person_t::shore1;
+								  --state.boat.passengers;
+							  });
+			else if (s.boat.pos == boat_t::shore2) // leave the boat to shore2
+				res.push_back([i](state_t& state){
+								  state.persons[i].pos = person_t::shore2;
+								  --state.boat.passengers;
+							  });
+			break;
+		}
+	}
+	return res;
+}
+
+inline bool river_crossing_valid(const state_t& s)
+{
+	if (s.boat.passengers > s.boat.capacity) {
+		log(" boat overload\n");
+		return false;
+	}
+	if (s.boat.pos == boat_t::travel) {
+		if (s.persons[person_t::daughter1].pos == person_t::onboard) {
+			if (s.boat.passengers==1 ||
+				(s.persons[person_t::daughter2].pos == person_t::onboard) ||
+				(s.persons[person_t::son1].pos == person_t::onboard) ||
+				(s.persons[person_t::son2].pos == person_t::onboard) ||
+				(s.persons[person_t::prisoner].pos == person_t::onboard)) {
+				log(" d1 travel alone\n");
+				return false;
+			}
+		} else if (s.persons[person_t::daughter2].pos == person_t::onboard) {
+			if (s.boat.passengers==1 ||
+				(s.persons[person_t::daughter1].pos == person_t::onboard) ||
+				(s.persons[person_t::son1].pos == person_t::onboard) ||
+				(s.persons[person_t::son2].pos == person_t::onboard) ||
+				(s.persons[person_t::prisoner].pos == person_t::onboard)) {
+				log(" d2 travel alone\n");
+				return false;
+			}
+		} else if (s.persons[person_t::son1].pos == person_t::onboard) {
+			if (s.boat.passengers==1 ||
+				(s.persons[person_t::daughter1].pos == person_t::onboard) ||
+				(s.persons[person_t::daughter2].pos == person_t::onboard) ||
+				(s.persons[person_t::son2].pos == person_t::onboard) ||
+				(s.persons[person_t::prisoner].pos == person_t::onboard)) {
+				log(" s1 travel alone\n");
+				return false;
+			}
+		} else if (s.persons[person_t::son2].pos == person_t::onboard) {
+			if (s.boat.passengers==1 ||
+				(s.persons[person_t::daughter1].pos == person_t::onboard) ||
+				(s.persons[person_t::daughter2].pos == person_t::onboard) ||
+				(s.persons[person_t::son1].pos == person_t::onboard) ||
+				(s.persons[person_t::prisoner].pos == person_t::onboard)) {
+				log(" s2 travel alone\n");
+				return false;
+			}
+		}
+		if (s.persons[person_t::prisoner].pos != s.persons[person_t::policeman].pos) {
+			auto prisoner_pos = s.persons[person_t::prisoner].pos;
+			if ((s.persons[person_t::daughter1].pos == prisoner_pos) ||
+				(s.persons[person_t::daughter2].pos == prisoner_pos) ||
+				(s.persons[person_t::son1].pos == prisoner_pos) ||
+				(s.persons[person_t::son2].pos == prisoner_pos) ||
+				(s.persons[person_t::mother].pos == prisoner_pos) ||
+				(s.persons[person_t::father].pos == prisoner_pos)) {
+				log(" pr with family\n");
+				return false;
+			}
+		}
+		if (s.persons[person_t::prisoner].pos == person_t::onboard && s.boat.passengers<2) {
+			log(" pr on boat\n");
+			return false;
+		}
+	}
+	if ((s.persons[person_t::daughter1].pos == s.persons[person_t::father].pos) &&
+		(s.persons[person_t::daughter1].pos != s.persons[person_t::mother].pos)) {
+		log(" d1 with f\n");
+		return false;
+	} else if ((s.persons[person_t::daughter2].pos == s.persons[person_t::father].pos) &&
+			   (s.persons[person_t::daughter2].pos != s.persons[person_t::mother].pos)) {
+		log(" d2 with f\n");
+		return false;
+	} else if ((s.persons[person_t::son1].pos == s.persons[person_t::mother].pos) &&
+			   (s.persons[person_t::son1].pos != s.persons[person_t::father].pos)) {
+		log(" s1 with m\n");
+		return false;
+	} else if ((s.persons[person_t::son2].pos == s.persons[person_t::mother].pos) &&
+			   (s.persons[person_t::son2].pos != s.persons[person_t::father].pos)) {
+		log(" s2 with m\n");
+		return false;
+	}
+	log(" OK\n");
+	return true;
+}
+
+struct cost_t {
+	size_t depth{0}; // counts the number of transitions
+	size_t noise{0}; // kids get bored on shore1 and start making noise there
+	bool operator<(const cost_t& other) const {
+		if (depth < other.depth)
+			return true;
+		if (other.depth < depth)
+			return false;
+		return noise < other.noise;
+	}
+};
+inline std::ostream& operator<<(std::ostream& stream, cost_t cost)
+{
+	stream << "noise: " << cost.noise << std::endl;
+	stream << "depth: " << cost.depth << std::endl;
+	return stream << std::endl;
+}
+inline bool goal(const state_t& s){
+	return std::all_of(std::begin(s.persons), std::end(s.persons),
+					   [](const person_t& p) { return p.pos == person_t::shore2; });
+}
+
+#endif //FAMILY_H
@@ -6,64 +6,13 @@
  * g++ -std=c++17 -pedantic -Wall -DNDEBUG -O3 -o frogs frogs.cpp && ./frogs
  */
 #include "reachability.hpp" // your header-only library solution
+#include "frogs.hpp" // model of the puzzle
 #include <iostream>
 #include <vector>
 #include <list>
 #include <functional> // std::function
-
-enum class frog { empty, green, brown };
-using stones_t = std::vector<frog>;
-
-std::ostream& operator<<(std::ostream& stream, stones_t state)
-{
-	for (auto& frog : state)
-	{
-		if(frog == frog::empty)
-			stream << "_";		
-		if(frog == frog::green)
-			stream << "G";	
-		if(frog == frog::brown)
-			stream << "B";		
-	}
-	stream << std::endl;
-	return stream;
-}
-
-auto transitions(const stones_t& stones)
-{
-	auto res = std::vector<std::function<void(stones_t&)>>{};
-	if (stones.size()<2)
-		return res;
-	auto i=0u;
-	while (i < stones.size() && stones[i]!=frog::empty) ++i; // find empty stone
-	if (i==stones.size())
-		return res;  // did not find empty stone
-	// explore moves to fill the empty from left to right (only green can do that):
-	if (i > 0 && stones[i-1]==frog::green)
-		res.push_back([i](stones_t& s){ // green jump to next
-						  s[i-1] = frog::empty;
-						  s[i]   = frog::green;
-					  });
-	if (i > 1 && stones[i-2]==frog::green)
-		res.push_back([i](stones_t& s){ // green jump over 1
-						  s[i-2] = frog::empty;
-						  s[i]   = frog::green;
-					  });
-	// explore moves to fill the empty from right to left (only brown can do that):
-	if (i < stones.size()-1 && stones[i+1]==frog::brown) {
-		res.push_back([i](stones_t& s){ // brown jump to next
-						  s[i+1] = frog::empty;
-						  s[i]   = frog::brown;
-					  });
-	}
-	if (i < stones.size()-2 && stones[i+2]==frog::brown) {
-		res.push_back([i](stones_t& s){ // brown jump over 1
-						  s[i+2]=frog::empty;
-						  s[i]=frog::brown;
-					  });
-	}
-	return res;
-}
+#include <future>
+#include <chrono>
 
 void show_successors(const stones_t& state, const size_t level=0)
 {
@@ -120,21 +69,93 @@ void solve(size_t frogs, search_order_t order = search_order_t::breadth_first)
 		std::move(start),                 // initial state
 		successors<stones_t>(transitions) // successor-generating function from your library
 	};
-	auto solutions = space.check(
-		[finish=std::move(finish)](const stones_t& state){ return state==finish; },
-		order);
+	space.memory_budget(std::size_t{1} << 30); // degrade to fingerprints/bitstate rather than running out of memory
+	space.count_hardware_events();
+	space.time_phases();
+	space.compress_chains(); // frogs only leap forward, and many layouts leave a single move (depth first search only)
+	auto statistics = search_statistics_t{};
+	auto solutions = space.check(goal_set_t{finish}, order, statistics); // the goal is a concrete state
+	std::cout << "Statistics: " << statistics << '\n';
 	std::cout << "Solution: a trace of " << "X" << " states\n";
 	for (auto&& trace: solutions) {
 		std::cout << "State of 5 stones:" << trace;
 	}
 }
 
+void solve_async(size_t max_frogs)
+{
+	// Queries of several sizes run concurrently on the engine's thread pool, the largest one reports its progress
+	auto queries = std::vector<std::future<search_result_t<stones_t>>>{};
+	for (auto frogs = size_t{1}; frogs <= max_frogs; ++frogs) {
+		auto [start, finish] = puzzle(frogs);
+		auto space = state_space_t{std::move(start), successors<stones_t>(transitions)};
+		auto progress = progress_callback_t{};
+		if (frogs == max_frogs)
+			progress = [](const search_progress_t& progress){
+				std::clog << "Explored " << progress.explored << ", waiting " << progress.frontier << ", depth " << progress.depth << '\n';
+			};
+		queries.push_back(space.check_async([finish=std::move(finish)](const stones_t& state){ return state==finish; },
+											search_order_t::breadth_first, cancellation_token_t{}, std::move(progress),
+											std::chrono::milliseconds{10}));
+	}
+	for (auto i = size_t{0}; i < queries.size(); ++i) {
+		auto result = queries[i].get();
+		std::cout << i+1 << " frogs: " << search_status_names[static_cast<int>(result.status)]
+				  << ", explored " << result.explored << ", solution of " << result.solution.size() << " states\n";
+	}
+}
+
+void solve_by_distances(size_t frogs)
+{
+	const auto [start, finish] = puzzle(frogs);
+	auto space = state_space_t{start, successors<stones_t>(transitions)};
+	// One backward search from the goal answers the queries from every state, each by a walk down the table
+	auto distances = space.goal_distances([&finish](const stones_t& state){ return state==finish; });
+	std::cout << distances.size() << " states can reach the goal, the start is " << *distances.distance(start) << " steps away\n";
+	auto solution = space.check_distances(distances);
+	auto halfway = *std::next(solution.begin(), solution.size()/2);
+	std::cout << "Solution from halfway: a trace of " << space.check_distances(distances, halfway).size() << " states\n";
+}
+
+void solve_from_any_gap(size_t frogs)
+{
+	// The frogs may start with the gap anywhere: one search from all the layouts finds the closest to the goal
+	auto starts = std::vector<stones_t>{};
+	for (auto gap = size_t{0}; gap <= frogs*2; ++gap) {
+		auto start = stones_t(frogs, frog::green);
+		start.insert(start.end(), frogs, frog::brown);
+		start.insert(start.begin()+gap, frog::empty);
+		starts.push_back(std::move(start));
+	}
+	auto finish = stones_t(frogs, frog::brown);
+	finish.push_back(frog::empty);
+	finish.insert(finish.end(), frogs, frog::green);
+	auto space = state_space_t{starts.begin(), starts.end(), successors<stones_t>(transitions)};
+	auto goal = [&finish](const stones_t& state){ return state==finish; };
+	auto solution = space.check(goal);
+	std::cout << "Solution: a trace of " << solution.size() << " states from " << solution.front();
+	// Most layouts are a move away from another one, the explored graph must still keep every start a node of its own
+	space.cache_graph();
+	auto cached = space.check(goal);
+	std::cout << "Over the explored graph: a trace of " << cached.size() << " states from " << cached.front();
+	std::cout << "The 3 shortest solutions have";
+	for (auto& shortest: space.check_k_shortest(goal, 3))
+		std::cout << " " << shortest.size();
+	std::cout << " states\n";
+}
+
 int main()
 {
 	explain();
 	std::cout << "--- Solve with depth-first search: ---\n";
 	solve(2, search_order_t::depth_first);
 	solve(4); // 20 frogs may take >5.8GB of memory
+	std::cout << "--- Solve concurrently: ---\n";
+	solve_async(6);
+	std::cout << "--- Solve by a distance table: ---\n";
+	solve_by_distances(5);
+	std::cout << "--- Solve from any gap: ---\n";
+	solve_from_any_gap(4);
 }
 /** Sample output:
 Leaping frog puzzle start: GG_BB
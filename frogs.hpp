@@ -0,0 +1,84 @@
+/**
+ * Model for leaping frogs puzzle:
+ * https://primefactorisation.com/frogpuzzle/
+ * Author: Marius Mikucionis <marius@cs.aau.dk>
+ */
+#include "reachability.hpp"
+#include <iostream>
+#include <vector>
+#include <utility> // std::pair
+#include <functional> // std::function
+
+#ifndef FROGS_H // include guards
+#define FROGS_H
+
+enum class frog { empty, green, brown };
+using stones_t = std::vector<frog>;
+
+inline std::ostream& operator<<(std::ostream& stream, stones_t state)
+{
+	for (auto& frog : state)
+	{
+		if(frog == frog::empty)
+			stream << "_";		
+		if(frog == frog::green)
+			stream << "G";	
+		if(frog == frog::brown)
+			stream << "B";		
+	}
+	stream << std::endl;
+	return stream;
+}
+
+inline auto transitions(const stones_t& stones)
+{
+	auto res = std::vector<std::function<void(stones_t&)>>{};
+	if (stones.size()<2)
+		return res;
+	auto i=0u;
+	while (i < stones.size() && stones[i]!=frog::empty) ++i; // find empty stone
+	if (i==stones.size())
+		return res;  // did not find empty stone
+	// explore moves to fill the empty from left to right (only green can do that):
+	if (i > 0 && stones[i-1]==frog::green)
+		res.push_back([i](stones_t& s){ // green jump to next
+						  s[i-1] = frog::empty;
+						  s[i]   = frog::green;
+					  });
+	if (i > 1 && stones[i-2]==frog::green)
+		res.push_back([i](stones_t& s){ // green jump over 1
+						  s[i-2] = frog::empty;
+						  s[i]   = frog::green;
+					  });
+	// explore moves to fill the empty from right to left (only brown can do that):
+	if (i < stones.size()-1 && stones[i+1]==frog::brown) {
+		res.push_back([i](stones_t& s){ // brown jump to next
+						  s[i+1] = frog::empty;
+						  s[i]   = frog::brown;
+					  });
+	}
+	if (i < stones.size()-2 && stones[i+2]==frog::brown) {
+		res.push_back([i](stones_t& s){ // brown jump over 1
+						  s[i+2]=frog::empty;
+						  s[i]=frog::brown;
+					  });
+	}
+	return res;
+}
+
+// Start and finish of the puzzle with the given number of frogs on either side:
+// green on the left and brown on the right at the start, the other way around at the finish
+inline std::pair<stones_t, stones_t> puzzle(size_t frogs)
+{
+	auto start = stones_t(frogs*2+1, frog::empty);
+	auto finish = stones_t(frogs*2+1, frog::empty);
+	for (auto i = size_t{0}; i < frogs; ++i) {
+		start[i] = frog::green;
+		start[start.size()-i-1] = frog::brown;
+		finish[i] = frog::brown;
+		finish[finish.size()-i-1] = frog::green;
+	}
+	return {start, finish};
+}
+
+#endif //FROGS_H
@@ -0,0 +1,44 @@
+#include "state_batch.hpp"
+#include "state_hash.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+#ifndef GOAL_SET_H // include guards
+#define GOAL_SET_H
+
+// Concrete goal states, recognised by comparing with each (a few goals, see find_state) or by hash set lookup instead
+// of an opaque predicate.
+// It is a predicate too, so it can be passed wherever a goal predicate is expected.
+template <typename State_t>
+class goal_set_t
+{
+public:
+    goal_set_t(std::initializer_list<State_t> goals) : goal_set_t(goals.begin(), goals.end()) {}
+
+    template <typename Iterator>
+    goal_set_t(Iterator first, Iterator last) : states(first, last), lookup(first, last) {}
+
+    bool operator()(const State_t &state) const
+    {
+        if (states.size() <= scanned_goals)
+            return find_state(states.data(), states.size(), state) != states.size();
+        return lookup.count(state) != 0;
+    }
+
+    std::size_t size() const noexcept { return states.size(); }
+    auto begin() const noexcept { return states.begin(); }
+    auto end() const noexcept { return states.end(); }
+
+private:
+    static constexpr std::size_t scanned_goals = 16;
+    std::vector<State_t> states;
+    std::unordered_set<State_t, state_hasher, state_equal> lookup;
+};
+
+template <typename Iterator>
+goal_set_t(Iterator, Iterator) -> goal_set_t<typename std::iterator_traits<Iterator>::value_type>;
+
+#endif //GOAL_SET_H
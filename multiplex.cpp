@@ -0,0 +1,41 @@
+/**
+ * Many small leaping frog queries and a large one multiplexed as coroutines on the engine's thread pool.
+ * Compile using (needs C++20 for coroutines):
+ * g++ -std=c++20 -pedantic -Wall -DNDEBUG -O3 -o multiplex multiplex.cpp -pthread && ./multiplex
+ */
+#include "reachability.hpp" // your header-only library solution
+#include "frogs.hpp" // model of the puzzle
+#include <iostream>
+#include <vector>
+#include <future>
+#include <chrono>
+
+auto query(search_scheduler_t& scheduler, size_t frogs, search_budget_t budget = {})
+{
+	auto [start, finish] = puzzle(frogs);
+	auto space = state_space_t{std::move(start), successors<stones_t>(transitions)};
+	return scheduler.submit(space.check_coroutine([finish=std::move(finish)](const stones_t& state){ return state==finish; },
+												  search_order_t::breadth_first, 256), budget);
+}
+
+int main()
+{
+	auto scheduler = search_scheduler_t{};
+	auto begin = std::chrono::steady_clock::now();
+	// The large query is submitted first with a budget, yet the small ones need not wait for it
+	auto large = query(scheduler, 12, search_budget_t{50000, std::chrono::seconds{2}});
+	auto small = std::vector<std::future<search_result_t<stones_t>>>{};
+	for (auto i = 0; i < 1000; ++i)
+		small.push_back(query(scheduler, 1 + i % 5));
+	auto solved = 0;
+	for (auto& result: small)
+		solved += result.get().status == search_status_t::solved;
+	auto small_done = std::chrono::steady_clock::now();
+	auto result = large.get();
+	auto large_done = std::chrono::steady_clock::now();
+	std::cout << "Small queries solved: " << solved << " of " << small.size() << " in "
+			  << std::chrono::duration_cast<std::chrono::milliseconds>(small_done - begin).count() << "ms\n";
+	std::cout << "Large query: " << search_status_names[static_cast<int>(result.status)] << ", explored " << result.explored
+			  << ", frontier depth " << result.frontier.size() << ", in "
+			  << std::chrono::duration_cast<std::chrono::milliseconds>(large_done - begin).count() << "ms\n";
+}
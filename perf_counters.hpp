@@ -0,0 +1,129 @@
+#include "statistics.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifndef PERF_COUNTERS_H // include guards
+#define PERF_COUNTERS_H
+
+// Counts hardware events of the calling thread (user space only) via Linux perf_event_open.
+// The events are opened as one group, so they are scheduled on the PMU together and count over the same interval.
+// If the group had to share the PMU with other events, the counts are scaled up to the whole interval
+// (see hardware_counters_t::running). Events the kernel or the hardware do not provide (or everything, on other
+// systems) are reported as -1.
+class perf_counters_t
+{
+public:
+    perf_counters_t() noexcept
+    {
+#if defined(__linux__)
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, events> configs{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        }};
+        // The first event opened leads the group, the others follow it from the start
+        for (auto i = 0u; i < events; ++i)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = configs[i].first;
+            attr.config = configs[i].second;
+            attr.disabled = leader < 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (leader < 0)
+                leader = fds[i];
+        }
+#endif
+    }
+    ~perf_counters_t()
+    {
+#if defined(__linux__)
+        for (auto fd : fds)
+            if (fd >= 0)
+                close(fd);
+#endif
+    }
+    perf_counters_t(const perf_counters_t &) = delete;
+    perf_counters_t &operator=(const perf_counters_t &) = delete;
+
+    void start() noexcept
+    {
+#if defined(__linux__)
+        if (leader >= 0)
+        {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    hardware_counters_t stop() noexcept
+    {
+        std::array<long long, events> values{-1, -1, -1, -1, -1};
+        double running = -1;
+#if defined(__linux__)
+        // The group's number of events, its times enabled and running, then the value of each event in opening order
+        std::array<std::uint64_t, 3 + events> group{};
+        if (leader >= 0)
+        {
+            ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            auto bytes = read(leader, group.data(), sizeof(group));
+            // A group never scheduled on the PMU counted nothing, which is not the same as no events
+            if (bytes >= static_cast<ssize_t>(3 * sizeof(std::uint64_t)) && bytes >= static_cast<ssize_t>((3 + group[0]) * sizeof(std::uint64_t)) && group[1] > 0 && group[2] > 0)
+            {
+                running = static_cast<double>(group[2]) / group[1];
+                auto value = group.begin() + 3;
+                for (auto i = 0u; i < events; ++i)
+                    if (fds[i] >= 0)
+                        values[i] = std::llround(*value++ / running);
+            }
+        }
+#endif
+        return {values[0], values[1], values[2], values[3], values[4], running};
+    }
+
+private:
+    static constexpr std::size_t events = 5;
+    std::array<int, events> fds{-1, -1, -1, -1, -1};
+    int leader{-1};
+};
+
+// Counts hardware events during its own lifetime into the given result, if enabled (RAII)
+class scoped_perf_counters_t
+{
+public:
+    scoped_perf_counters_t(bool enable, hardware_counters_t &counters) : result{counters}
+    {
+        if (enable)
+            events.emplace();
+        if (events)
+            events->start();
+    }
+    ~scoped_perf_counters_t()
+    {
+        if (events)
+            result = events->stop();
+    }
+    scoped_perf_counters_t(const scoped_perf_counters_t &) = delete;
+    scoped_perf_counters_t &operator=(const scoped_perf_counters_t &) = delete;
+
+private:
+    std::optional<perf_counters_t> events{};
+    hardware_counters_t &result;
+};
+
+#endif //PERF_COUNTERS_H
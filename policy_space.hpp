@@ -0,0 +1,245 @@
+#include "reachability.hpp"
+#include "state_hash.hpp"
+#include "state_table.hpp"
+#include "statistics.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifndef POLICY_SPACE_H // include guards
+#define POLICY_SPACE_H
+
+// Frontier policies: the waiting states, popped in the order they are expanded
+
+// Breadth first: the oldest waiting state
+template <typename State_t>
+class fifo_frontier_t
+{
+    std::deque<State_t> states{};
+
+public:
+    bool empty() const noexcept { return states.empty(); }
+    std::size_t size() const noexcept { return states.size(); }
+    void push(const State_t &state) { states.push_back(state); }
+
+    State_t pop()
+    {
+        auto state = std::move(states.front());
+        states.pop_front();
+        return state;
+    }
+};
+
+// Depth first: the newest waiting state
+template <typename State_t>
+class lifo_frontier_t
+{
+    std::vector<State_t> states{};
+
+public:
+    bool empty() const noexcept { return states.empty(); }
+    std::size_t size() const noexcept { return states.size(); }
+    void push(const State_t &state) { states.push_back(state); }
+
+    State_t pop()
+    {
+        auto state = std::move(states.back());
+        states.pop_back();
+        return state;
+    }
+};
+
+// Cost guided: the first waiting state of least cost, each cost computed from the cost of the last popped state
+// (the rule of state_space_t's cost guided order, hence no heap: the costs change with every pop)
+template <typename State_t, typename Cost_t, typename Cost_fn>
+class cheapest_frontier_t
+{
+    std::deque<State_t> states{};
+    std::vector<Cost_t> costs{};
+    Cost_fn cost_function;
+    Cost_t previous_cost;
+
+public:
+    cheapest_frontier_t(const Cost_t &initial_cost, const Cost_fn &cost_fn)
+        : cost_function{cost_fn},
+          previous_cost{initial_cost} {}
+
+    bool empty() const noexcept { return states.empty(); }
+    std::size_t size() const noexcept { return states.size(); }
+    void push(const State_t &state) { states.push_back(state); }
+
+    State_t pop()
+    {
+        costs.clear();
+        for (auto &state : states)
+            costs.push_back(cost_function(state, previous_cost));
+        auto index = std::distance(costs.begin(), std::min_element(costs.begin(), costs.end()));
+        previous_cost = costs[index];
+        auto state = std::move(states[index]);
+        states.erase(states.begin() + index);
+        return state;
+    }
+};
+
+// Closed set policies: the states waiting or passed, each with the state it was reached from (initial states with themselves)
+
+template <typename Parents>
+std::list<typename Parents::key_type> parent_path(const Parents &parents, typename Parents::key_type state)
+{
+    std::list<typename Parents::key_type> path{state};
+    for (auto parent = parents.find(state); !state_equal{}(parent->second, path.front()); parent = parents.find(path.front()))
+        path.push_front(parent->second);
+    return path;
+}
+
+// Open-addressed (state_table_t): besides growing its arrays, it allocates only what the states own
+template <typename State_t>
+class hashed_closed_t
+{
+    state_table_t<State_t> parents{};
+
+public:
+    std::size_t size() const noexcept { return parents.size(); }
+    bool contains(const State_t &state) const { return parents.contains(state, state_hash(state)); }
+    // Returns false if the state was already closed
+    bool insert(const State_t &state, const State_t &parent) { return parents.insert(state, parent, state_hash(state)); }
+
+    std::list<State_t> path(const State_t &state) const
+    {
+        std::list<State_t> path{state};
+        for (auto parent = &parents.parent(state, state_hash(state)); !state_equal{}(*parent, path.front());
+             parent = &parents.parent(path.front(), state_hash(path.front())))
+            path.push_front(*parent);
+        return path;
+    }
+};
+
+template <typename State_t>
+class ordered_closed_t
+{
+    std::map<State_t, State_t, state_less> parents{};
+
+public:
+    std::size_t size() const noexcept { return parents.size(); }
+    bool contains(const State_t &state) const { return parents.count(state) != 0; }
+    bool insert(const State_t &state, const State_t &parent) { return parents.try_emplace(state, parent).second; }
+    std::list<State_t> path(const State_t &state) const { return parent_path(parents, state); }
+};
+
+// Invariant that accepts every state, so that the check compiles away
+struct no_invariant_t
+{
+    template <typename State_t>
+    constexpr bool operator()(const State_t &) const noexcept { return true; }
+};
+
+// A lean search loop of its own with the frontier, closed set, invariant (and through the frontier, the cost function)
+// fixed at compile time, so that the whole loop is specialised and inlined per model. It does not share the loop of
+// state_space_t, which carries the memory budget, chain compression, cancellation, anytime search, progress reports and
+// the graph cache, and is not kept equivalent to it: only the successor generators and the ample proviso are common.
+// Statistics count states and the total time, not the phases.
+template <typename State_t, typename Successor_gen, typename Frontier_t = fifo_frontier_t<State_t>,
+          typename Closed_t = hashed_closed_t<State_t>, typename Invariant_fn = no_invariant_t>
+class policy_space_t
+{
+    State_t initial_state;
+    Successor_gen successors_function;
+    Invariant_fn invariant;
+    Frontier_t initial_frontier; // copied by each search, e.g. with the cost function and initial cost
+
+    template <typename Successors>
+    void add_successors(const Successors &all_successors, const State_t &curr_state, Frontier_t &waiting, Closed_t &closed,
+                        search_statistics_t &statistics) const
+    {
+        for (auto &succ : all_successors)
+        {
+            ++statistics.generated;
+            if (!invariant(succ))
+                ++statistics.rejected;
+            else if (!closed.insert(succ, curr_state))
+                ++statistics.deduplicated;
+            else
+                waiting.push(succ);
+        }
+    }
+
+public:
+    explicit policy_space_t(const State_t &state, const Successor_gen &succ, const Invariant_fn &invariant_fn = {},
+                            const Frontier_t &frontier = {})
+        : initial_state{state},
+          successors_function{succ},
+          invariant{invariant_fn},
+          initial_frontier{frontier} {}
+
+    template <typename Goal_pred>
+    std::list<State_t> check(const Goal_pred &goal_pred, search_statistics_t &statistics) const
+    {
+        statistics = search_statistics_t{};
+        scoped_duration_t total{statistics.time.total};
+        auto waiting = initial_frontier;
+        Closed_t closed{};
+        closed.insert(initial_state, initial_state);
+        waiting.push(initial_state);
+        while (!waiting.empty())
+        {
+            auto curr_state = waiting.pop();
+            if (goal_pred(curr_state))
+                return closed.path(curr_state);
+            ++statistics.expanded;
+            auto all_successors = successors_function(curr_state);
+            if constexpr (is_ample_set<decltype(all_successors)>::value)
+                add_successors(ample_proviso(all_successors, [&](const State_t &succ) { return invariant(succ) && !closed.contains(succ); }),
+                               curr_state, waiting, closed, statistics);
+            else
+                add_successors(all_successors, curr_state, waiting, closed, statistics);
+            statistics.peak_frontier = std::max(statistics.peak_frontier, waiting.size());
+            statistics.peak_visited = std::max(statistics.peak_visited, closed.size());
+        }
+        throw new std::logic_error("No solution could be found");
+    }
+
+    template <typename Goal_pred>
+    std::list<State_t> check(const Goal_pred &goal_pred) const
+    {
+        search_statistics_t statistics{};
+        return check(goal_pred, statistics);
+    }
+};
+
+template <typename State_t, typename Successor_gen>
+policy_space_t(State_t, Successor_gen) -> policy_space_t<State_t, Successor_gen>;
+template <typename State_t, typename Successor_gen, typename Invariant_fn>
+policy_space_t(State_t, Successor_gen, Invariant_fn) -> policy_space_t<State_t, Successor_gen, fifo_frontier_t<State_t>, hashed_closed_t<State_t>, Invariant_fn>;
+template <typename State_t, typename Successor_gen, typename Invariant_fn, typename Frontier_t>
+policy_space_t(State_t, Successor_gen, Invariant_fn, Frontier_t) -> policy_space_t<State_t, Successor_gen, Frontier_t, hashed_closed_t<State_t>, Invariant_fn>;
+
+// The runtime search order over policy_space_t: dispatched once per search instead of once per popped state
+template <typename State_t, typename Cost_t, typename Successor_gen, typename Invariant_fn, typename Cost_fn, typename Goal_pred>
+std::list<State_t> check_static(const State_t &state, const Cost_t &cost, const Successor_gen &succ, const Invariant_fn &invariant_fn,
+                                const Cost_fn &cost_fn, const Goal_pred &goal_pred, search_order_t search_order, search_statistics_t &statistics)
+{
+    switch (search_order)
+    {
+    case search_order_t::depth_first:
+        return policy_space_t{state, succ, invariant_fn, lifo_frontier_t<State_t>{}}.check(goal_pred, statistics);
+    case search_order_t::breadth_first:
+        return policy_space_t{state, succ, invariant_fn, fifo_frontier_t<State_t>{}}.check(goal_pred, statistics);
+    case search_order_t::cost_guided:
+        return policy_space_t{state, succ, invariant_fn, cheapest_frontier_t<State_t, Cost_t, Cost_fn>{cost, cost_fn}}.check(goal_pred, statistics);
+    }
+    throw new std::invalid_argument("The given search order is not supported.");
+}
+
+template <typename State_t, typename Successor_gen, typename Invariant_fn, typename Goal_pred>
+std::list<State_t> check_static(const State_t &state, const Successor_gen &succ, const Invariant_fn &invariant_fn,
+                                const Goal_pred &goal_pred, search_order_t search_order, search_statistics_t &statistics)
+{
+    return check_static(state, 0, succ, invariant_fn, default_cost_function<int, State_t>, goal_pred, search_order, statistics);
+}
+
+#endif //POLICY_SPACE_H
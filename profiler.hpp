@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef PROFILER_H // include guards
+#define PROFILER_H
+
+// Hierarchical scoped profiler, enabled by compiling with -DPROFILING (cmake -DPROFILING=ON).
+// PROFILE_ZONE("name") measures the rest of the enclosing scope; nested zones form a call tree.
+// Each thread counts into its own tree without locking, the trees are merged and reported to std::cerr at exit.
+// Past its first timed_calls calls, only every sample_period-th call of a zone reads the clock and the zone's time is
+// extrapolated from the calls timed, less the cost of the clock reads calibrated at exit.
+// A thread still running when static objects are destroyed (e.g. a worker of a static thread_pool_t) must be
+// started after the registry was created, as thread_pool_t makes sure of.
+// Without PROFILING the macro expands to nothing.
+#ifdef PROFILING
+
+namespace profiler
+{
+    // Time stamp counter where available, steady_clock ticks otherwise
+    inline std::uint64_t ticks() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    // The first timed_calls calls of each zone are timed, then one call in sample_period
+    constexpr std::uint64_t timed_calls = 256;
+    constexpr std::uint64_t sample_period = 16;
+
+    // A static location in the code measured by PROFILE_ZONE
+    struct site_t
+    {
+        const char *name;
+    };
+
+    struct node_t
+    {
+        const site_t *site;
+        std::uint32_t parent;
+        std::uint64_t calls{0};
+        std::uint64_t samples{0}; // calls timed
+        std::uint64_t ticks{0};   // of the calls timed
+        std::vector<std::uint32_t> children{};
+
+        // Ticks of all calls, extrapolated from the calls timed less the given overhead of timing one
+        double estimated_ticks(double overhead) const noexcept
+        {
+            return samples == 0 ? 0.0 : std::max(0.0, static_cast<double>(ticks) - overhead * samples) * calls / samples;
+        }
+    };
+
+    // Call tree of the zones entered on one thread
+    class call_tree_t
+    {
+    public:
+        std::uint32_t enter(const site_t &site)
+        {
+            for (auto child : nodes[current].children)
+                if (nodes[child].site == &site)
+                    return current = child;
+            auto child = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back(node_t{&site, current});
+            nodes[current].children.push_back(child);
+            return current = child;
+        }
+
+        const node_t &node(std::uint32_t index) const noexcept { return nodes[index]; }
+
+        // Whether the call of the node just entered is timed
+        bool sampled(std::uint32_t node) const noexcept
+        {
+            auto calls = nodes[node].calls;
+            return calls < timed_calls || calls % sample_period == 0;
+        }
+
+        // Ends a call of the node, timed from start unless it is 0 (not sampled)
+        void leave(std::uint32_t node, std::uint64_t start) noexcept
+        {
+            auto &left = nodes[node];
+            if (start != 0)
+            {
+                left.ticks += ticks() - start;
+                ++left.samples;
+            }
+            ++left.calls;
+            current = left.parent;
+        }
+
+    protected:
+        std::vector<node_t> nodes{node_t{nullptr, 0}}; // node 0 is the root
+        std::uint32_t current{0};
+    };
+
+    // Measures its own lifetime as one call of a site (RAII), reading the clock only for sampled calls
+    class zone_t
+    {
+    public:
+        zone_t(call_tree_t &tree, const site_t &site)
+            : tree{tree},
+              node{tree.enter(site)},
+              start{tree.sampled(node) ? ticks() : 0} {}
+        ~zone_t() { tree.leave(node, start); }
+
+        zone_t(const zone_t &) = delete;
+        zone_t &operator=(const zone_t &) = delete;
+
+    private:
+        call_tree_t &tree;
+        std::uint32_t node;
+        std::uint64_t start;
+    };
+
+    // Collects the call trees of finished threads and prints the merged report when the program exits
+    class registry_t
+    {
+    public:
+        registry_t() noexcept
+            : start_ticks{ticks()},
+              start_time{std::chrono::steady_clock::now()} {}
+        ~registry_t() { report(std::cerr); }
+
+        void collect(std::vector<node_t> nodes)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            threads.push_back(std::move(nodes));
+        }
+
+        void report(std::ostream &stream)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            // Calibrate the tick rate against steady_clock over the lifetime of the program (at least 10ms)
+            auto end_time = std::chrono::steady_clock::now();
+            while (end_time - start_time < std::chrono::milliseconds{10})
+                end_time = std::chrono::steady_clock::now();
+            auto elapsed = std::chrono::duration<double, std::nano>(end_time - start_time).count();
+            auto ns_per_tick = elapsed / static_cast<double>(ticks() - start_ticks);
+            auto overhead = timing_overhead();
+
+            // Merge the trees of all threads by the names along the path from the root
+            std::map<std::vector<std::string>, std::pair<std::uint64_t, double>> merged{};
+            for (auto &nodes : threads)
+                for (auto i = 1u; i < nodes.size(); ++i)
+                {
+                    std::vector<std::string> path{};
+                    for (auto node = i; node != 0; node = nodes[node].parent)
+                        path.insert(path.begin(), nodes[node].site->name);
+                    merged[path].first += nodes[i].calls;
+                    merged[path].second += nodes[i].estimated_ticks(overhead);
+                }
+            stream << "Profile of " << threads.size() << " thread(s), " << ns_per_tick << "ns per tick, "
+                   << overhead * ns_per_tick << "ns per timed call subtracted:\n";
+            for (auto &[path, counters] : merged)
+            {
+                auto ns = counters.second * ns_per_tick;
+                stream << std::string(2 * path.size(), ' ') << std::left << std::setw(32 - std::min<int>(2 * path.size(), 30)) << path.back() << std::right
+                       << std::setw(12) << counters.first << " calls"
+                       << std::setw(14) << std::fixed << std::setprecision(3) << ns / 1e6 << "ms"
+                       << std::setw(12) << std::setprecision(1) << ns / static_cast<double>(counters.first) << "ns/call\n";
+            }
+        }
+
+    private:
+        // Ticks measured by a timed call of an empty zone whose sampling branch is predicted, i.e. the clock reads: the
+        // lowest mean of several rounds, as the first ones run cold and any round may be interrupted
+        static double timing_overhead()
+        {
+            static const site_t site{"calibration"};
+            auto lowest = std::numeric_limits<double>::max();
+            for (auto round = 0; round < 16; ++round)
+            {
+                call_tree_t tree{};
+                for (auto call = 0u; call < timed_calls; ++call)
+                    zone_t zone{tree, site};
+                auto &calls = tree.node(1);
+                lowest = std::min(lowest, static_cast<double>(calls.ticks) / calls.samples);
+            }
+            return lowest;
+        }
+
+        std::mutex mutex{};
+        std::vector<std::vector<node_t>> threads{};
+        std::uint64_t start_ticks;
+        std::chrono::steady_clock::time_point start_time;
+    };
+
+    inline registry_t &registry()
+    {
+        static registry_t instance{};
+        return instance;
+    }
+
+    // Call tree of the current thread, handed to the registry when the thread exits
+    class thread_profile_t : public call_tree_t
+    {
+    public:
+        thread_profile_t() { registry(); } // make sure the registry outlives this thread profile
+        ~thread_profile_t() { registry().collect(std::move(nodes)); }
+    };
+
+    inline thread_profile_t &this_thread()
+    {
+        thread_local thread_profile_t profile{};
+        return profile;
+    }
+} // namespace profiler
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+#define PROFILE_ZONE(name)                                                            \
+    static const profiler::site_t PROFILER_CONCAT(profile_site_, __LINE__){name};     \
+    profiler::zone_t PROFILER_CONCAT(profile_zone_, __LINE__) { profiler::this_thread(), PROFILER_CONCAT(profile_site_, __LINE__) }
+
+#else
+
+#define PROFILE_ZONE(name) static_cast<void>(0)
+
+#endif //PROFILING
+
+#endif //PROFILER_H
@@ -6,7 +6,33 @@
 #include <functional>
 #include <iostream>
 #include <algorithm>
-#include "timer.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <optional>
+#include <utility>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "statistics.hpp"
+#include "profiler.hpp"
+#include "perf_counters.hpp"
+#include "alloc_tracker.hpp"
+#include "search_store.hpp"
+#include "state_hash.hpp"
+#include "cancellation.hpp"
+#include "thread_pool.hpp"
+#include "search_task.hpp"
+#include "distance_table.hpp"
+#include "goal_set.hpp"
+#include "state_batch.hpp"
 
 #ifndef REACHABILITY_H // include guards
 #define REACHABILITY_H
@@ -18,13 +44,52 @@ enum class search_order_t
     cost_guided
 };
 
+// Read/write footprint of a transition over (at most 64) model-defined state variables.
+// Reads must include everything the transition's guard, effect and the invariant depend on.
+struct footprint_t
+{
+    std::uint64_t reads{0};
+    std::uint64_t writes{0};
+};
+
+// Two transitions are independent if neither writes what the other reads or writes
+constexpr bool independent(const footprint_t &a, const footprint_t &b) noexcept
+{
+    return (a.writes & (b.reads | b.writes)) == 0 && (b.writes & a.reads) == 0;
+}
+
+// A transition annotated with its footprint and guard, callable like a plain transition. Without a guard it is always
+// enabled, the guard must only read variables in the footprint's reads.
+template <typename State_t>
+struct transition_t
+{
+    std::function<void(State_t &)> effect;
+    footprint_t footprint{~std::uint64_t{0}, ~std::uint64_t{0}};
+    std::function<bool(const State_t &)> guard{};
+    void operator()(State_t &state) const { effect(state); }
+};
+
+// Whether a transition applies to a state: plain transitions are only returned when they do, guarded ones are checked
+template <typename Transition, typename State_t>
+bool is_enabled(const Transition &, const State_t &) noexcept { return true; }
+
+template <typename State_t>
+bool is_enabled(const transition_t<State_t> &transition, const State_t &state) { return !transition.guard || transition.guard(state); }
+
 template <typename state_t, typename successor_generator>
 constexpr auto successors(const successor_generator &transitions) noexcept
 {
     return [&transitions](const state_t &current_state) {
+        ALLOC_PHASE(alloc_phase_t::successors);
+        auto enabled = [&] {
+            ALLOC_PHASE(alloc_phase_t::transitions);
+            return transitions(current_state);
+        }();
         std::list<state_t> all_successors{};
-        for (auto &transition : transitions(current_state))
+        for (auto &transition : enabled)
         {
+            if (!is_enabled(transition, current_state))
+                continue;
             state_t new_succ = current_state;
             transition(new_succ);
             all_successors.push_back(new_succ);
@@ -33,6 +98,271 @@ constexpr auto successors(const successor_generator &transitions) noexcept
     };
 };
 
+// Successors split into an ample set and the deferred rest, which is only explored if the ample set is not safe
+template <typename State_t>
+struct ample_set_t
+{
+    std::list<State_t> ample;
+    std::list<State_t> deferred;
+};
+
+// The successors of an ample set to expand: the ample ones if all of them are new, all of them otherwise (the proviso),
+// as a rejected or already seen ample successor might close a cycle that defers a transition forever
+template <typename State_t, typename Is_new>
+std::list<State_t> &ample_proviso(ample_set_t<State_t> &successors, const Is_new &is_new)
+{
+    if (!std::all_of(successors.ample.begin(), successors.ample.end(), is_new))
+        successors.ample.splice(successors.ample.end(), successors.deferred);
+    return successors.ample;
+}
+
+template <typename T>
+struct is_ample_set : std::false_type
+{
+};
+
+template <typename State_t>
+struct is_ample_set<ample_set_t<State_t>> : std::true_type
+{
+};
+
+// Partial-order reduced successor generator: transitions must return every transition of the model as transition_t,
+// the disabled ones with their guards too, as a pruned transition may enable one. The ample set is the enabled part of a
+// stubborn set grown from one enabled transition: it holds every transition dependent on an enabled member, and every
+// transition writing what a disabled member reads (which may enable it), so the pruned transitions can neither disable
+// an ample transition nor enable one outside the set. Visible is the set of variables read by the goal, stubborn sets
+// never write them. By default every variable is visible and nothing is pruned. Reduction pays off only if some states
+// are reachable by one interleaving alone: in puzzles whose moves can be undone, the states skipped are mostly reached anyway.
+template <typename state_t, typename successor_generator>
+constexpr auto ample_successors(const successor_generator &transitions, std::uint64_t visible = ~std::uint64_t{0}) noexcept
+{
+    return [&transitions, visible](const state_t &current_state) {
+        ALLOC_PHASE(alloc_phase_t::successors);
+        auto all = [&] {
+            ALLOC_PHASE(alloc_phase_t::transitions);
+            return transitions(current_state);
+        }();
+        std::vector<footprint_t> footprints{};
+        std::vector<bool> enabled{};
+        for (auto &transition : all)
+        {
+            footprints.push_back(transition.footprint);
+            enabled.push_back(is_enabled(transition, current_state));
+        }
+
+        // Grow a stubborn set from each invisible enabled transition, and keep the one with the fewest enabled
+        // transitions (all of them if none is invisible)
+        std::vector<bool> best = enabled;
+        auto best_size = static_cast<std::size_t>(std::count(enabled.begin(), enabled.end(), true));
+        for (auto i = 0u; i < footprints.size(); ++i)
+        {
+            if (!enabled[i] || (footprints[i].writes & visible) != 0)
+                continue;
+            std::vector<bool> stubborn(footprints.size(), false);
+            std::vector<std::size_t> work{i};
+            stubborn[i] = true;
+            auto size = std::size_t{1};
+            auto invisible = true;
+            while (!work.empty() && invisible && size < best_size)
+            {
+                auto k = work.back();
+                work.pop_back();
+                for (auto j = 0u; j < footprints.size(); ++j)
+                {
+                    auto needed = enabled[k] ? !independent(footprints[j], footprints[k]) : (footprints[j].writes & footprints[k].reads) != 0;
+                    if (stubborn[j] || !needed)
+                        continue;
+                    stubborn[j] = true;
+                    work.push_back(j);
+                    invisible = invisible && (footprints[j].writes & visible) == 0;
+                    size += enabled[j];
+                }
+            }
+            if (invisible && size < best_size)
+            {
+                for (auto j = 0u; j < footprints.size(); ++j)
+                    best[j] = stubborn[j] && enabled[j];
+                best_size = size;
+            }
+        }
+
+        ample_set_t<state_t> result{};
+        auto i = 0u;
+        for (auto &transition : all)
+        {
+            if (enabled[i])
+            {
+                state_t new_succ = current_state;
+                transition(new_succ);
+                (best[i] ? result.ample : result.deferred).push_back(new_succ);
+            }
+            ++i;
+        }
+        return result;
+    };
+};
+
+// Shape of the reachable state space as computed by state_space_t::explore
+struct exploration_t
+{
+    std::size_t states{0};             // number of reachable states upholding the invariant
+    std::size_t depth{0};              // length of the longest shortest path from the initial state
+    std::size_t terminal{0};           // number of states without valid successors (deadlocks or final states)
+    std::vector<std::size_t> layers{}; // number of states at each breadth-first distance
+};
+
+// Directed acyclic graph of all optimal parents, lazily enumerating every optimal solution (see state_space_t::check_all)
+template <typename State_t>
+class solution_dag_t
+{
+    std::set<State_t, state_less> initial_states;
+    std::vector<State_t> goals;
+    std::map<State_t, std::vector<State_t>, state_less> parents;
+
+public:
+    solution_dag_t(const std::vector<State_t> &initial, std::vector<State_t> goal_states, std::map<State_t, std::vector<State_t>, state_less> optimal_parents)
+        : initial_states{initial.begin(), initial.end()},
+          goals{std::move(goal_states)},
+          parents{std::move(optimal_parents)} {}
+
+    // Input iterator producing one solution (its initial state first) at a time
+    class iterator
+    {
+        const solution_dag_t *dag = nullptr;
+        std::size_t goal = 0;
+        // Path from a goal back to the initial state, each state with the index of the parent chosen after it
+        std::vector<std::pair<State_t, std::size_t>> path{};
+
+        void descend()
+        {
+            while (dag->initial_states.count(path.back().first) == 0)
+            {
+                auto &options = dag->parents.at(path.back().first);
+                State_t parent = options[path.back().second];
+                path.emplace_back(std::move(parent), 0);
+            }
+        }
+
+        void start_goal()
+        {
+            path.clear();
+            if (goal < dag->goals.size())
+            {
+                path.emplace_back(dag->goals[goal], 0);
+                descend();
+            }
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::list<State_t>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = value_type;
+
+        iterator() = default;
+        iterator(const solution_dag_t *owner, std::size_t first_goal) : dag{owner}, goal{first_goal} { start_goal(); }
+
+        std::list<State_t> operator*() const
+        {
+            std::list<State_t> solution{};
+            for (auto &entry : path)
+                solution.push_front(entry.first);
+            return solution;
+        }
+
+        iterator &operator++()
+        {
+            // Backtrack to the deepest state with an untried optimal parent
+            path.pop_back();
+            while (!path.empty())
+            {
+                if (++path.back().second < dag->parents.at(path.back().first).size())
+                {
+                    descend();
+                    return *this;
+                }
+                path.pop_back();
+            }
+            ++goal;
+            start_goal();
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const { return goal == other.goal && path.size() == other.path.size(); }
+        bool operator!=(const iterator &other) const { return !(*this == other); }
+    };
+
+    iterator begin() const { return iterator{this, 0}; }
+    iterator end() const { return iterator{this, goals.size()}; }
+    bool empty() const { return goals.empty(); }
+
+    // Number of optimal solutions, computed without enumerating them
+    std::size_t count() const
+    {
+        std::map<State_t, std::size_t, state_less> paths{};
+        std::function<std::size_t(const State_t &)> count_paths = [&](const State_t &state) -> std::size_t {
+            if (initial_states.count(state) != 0)
+                return 1;
+            auto found = paths.find(state);
+            if (found != paths.end())
+                return found->second;
+            std::size_t sum = 0;
+            for (auto &parent : parents.at(state))
+                sum += count_paths(parent);
+            return paths[state] = sum;
+        };
+        std::size_t total = 0;
+        for (auto &goal : goals)
+            total += count_paths(goal);
+        return total;
+    }
+};
+
+// Explicit reachable state graph: states indexed in discovery order with their valid successors.
+// size, state and successors are the graph interface of check_graph and explore_graph, which csr_graph_t also provides.
+template <typename State_t>
+struct state_graph_t
+{
+    std::vector<State_t> states{};
+    std::vector<std::vector<std::size_t>> edges{};
+
+    std::size_t size() const noexcept { return states.size(); }
+    const State_t &state(std::size_t index) const noexcept { return states[index]; }
+    const std::vector<std::size_t> &successors(std::size_t index) const noexcept { return edges[index]; }
+};
+
+// How a search ended
+enum class search_status_t
+{
+    solved,       // a goal was reached (cost guided with a token: the whole space was searched, the solution is the cheapest)
+    exhausted,    // every reachable state was visited without reaching a goal
+    cancelled,    // the cancellation token was cancelled or its deadline passed
+    out_of_memory // the memory budget was exhausted
+};
+
+constexpr const char *search_status_names[] = {"solved", "exhausted", "cancelled", "out_of_memory"};
+
+// Outcome of a search which does not throw when it ends without a solution
+template <typename State_t>
+struct search_result_t
+{
+    search_status_t status{search_status_t::exhausted};
+    std::list<State_t> solution{}; // path to a goal, empty if none was reached (anytime search: the cheapest found)
+    std::list<State_t> frontier{}; // without a solution: path to the cheapest waiting state, the most promising partial result
+    std::size_t explored{0};       // states expanded
+};
+
+// Snapshot of a running search, reported to the progress callback of state_space_t::check_async
+struct search_progress_t
+{
+    std::size_t explored{0}; // states expanded
+    std::size_t frontier{0}; // states waiting
+    std::size_t depth{0};    // steps from the initial state to the state being expanded (macro-steps with chain compression)
+};
+
+using progress_callback_t = std::function<void(const search_progress_t &)>;
+
 // Default cost function
 template <typename Cost_t, typename State_t>
 const auto default_cost_function = [](const State_t &state, const Cost_t &prev_cost) { return 0; };
@@ -50,58 +380,1392 @@ class state_space_t
     using Cost_fn = std::function<Cost_t(const State_t &, const Cost_t &)>;
 
 
-    State_t initial_state;
+    std::vector<State_t> initial_states;
     Cost_t initial_cost;
     Successor_gen successors_function;
     Invariant_type invariant = default_invariant<State_t>;
     Cost_fn cost_function = default_cost_function<Cost_t, State_t>;
     Cost_t previous_cost = initial_cost;
+    bool chain_compression = false;
+    bool compressing = false; // chain compression applies to the current search (see compress_chains)
+    bool graph_caching = false;
+    std::shared_ptr<const state_graph_t<State_t>> graph_cache{};
+    bool hardware_counting = false;
+    bool phase_timing = false;
+    std::size_t budget = std::numeric_limits<std::size_t>::max();
 
 public:
-    explicit state_space_t(const State_t &state, const Successor_gen &succ, const Invariant_type &invariant_fn = default_invariant<State_t>) noexcept
-        : initial_state{state},
+    explicit state_space_t(const State_t &state, const Successor_gen &succ, const Invariant_type &invariant_fn = default_invariant<State_t>)
+        : initial_states{state},
           initial_cost{0},
           successors_function{succ},
           invariant{invariant_fn} {}
-    explicit state_space_t(const State_t &state, const Cost_t &cost, const Successor_gen &succ, const Invariant_type &invariant_fn, const Cost_fn &cost_func) noexcept
-        : initial_state{state},
+    explicit state_space_t(const State_t &state, const Cost_t &cost, const Successor_gen &succ, const Invariant_type &invariant_fn, const Cost_fn &cost_func)
+        : initial_states{state},
           initial_cost{cost},
           successors_function{succ},
           invariant{invariant_fn},
           cost_function{cost_func} {}
 
+    // Searches from all the initial states in [first, last) at once, every solution starts with the one it was reached from
+    template <typename Iterator>
+    explicit state_space_t(Iterator first, Iterator last, const Successor_gen &succ, const Invariant_type &invariant_fn = default_invariant<State_t>)
+        : initial_states{unique_states(first, last)},
+          initial_cost{0},
+          successors_function{succ},
+          invariant{invariant_fn} {}
+    template <typename Iterator>
+    explicit state_space_t(Iterator first, Iterator last, const Cost_t &cost, const Successor_gen &succ, const Invariant_type &invariant_fn, const Cost_fn &cost_func)
+        : initial_states{unique_states(first, last)},
+          initial_cost{cost},
+          successors_function{succ},
+          invariant{invariant_fn},
+          cost_function{cost_func} {}
+
+    const std::vector<State_t> &initial() const noexcept { return initial_states; }
+
+    // Collapses runs of states with a single valid successor (besides the state they were reached from, so that moves
+    // which can be undone do not count) into one macro-edge, only the endpoints are stored and the runs are replayed
+    // when the solution is built. A run is followed when its first state is generated, ahead of the states waiting,
+    // so a goal stays reachable but the path to it may be longer: only depth first search, which does not promise the
+    // shortest path either, is compressed. Breadth first and cost guided searches ignore it.
+    void compress_chains(bool enable = true) noexcept { chain_compression = enable; }
+
+    // Counts hardware events (cycles, instructions, cache, branch and dTLB misses) of each check via perf_event_open
+    void count_hardware_events(bool enable = true) noexcept { hardware_counting = enable; }
+
+    // Times the phases of each check (search_statistics_t::time), at the cost of two clock reads around every
+    // generation, invariant, lookup and frontier operation. Without it only the total and the trace are timed.
+    void time_phases(bool enable = true) noexcept { phase_timing = enable; }
+
+    // Limits the estimated memory of check: near the budget visited states are compacted to fingerprints and then to a
+    // bitstate table, and the search stops if even that does not fit. A search that left the exact regime is reported
+    // incomplete, as a collision may have pruned a state. See search_statistics_t::regime/complete.
+    void memory_budget(std::size_t bytes) noexcept { budget = bytes; }
+
+    // Keeps the reachable state graph (the valid successors of every state) once a query has explored it, so that later
+    // queries with other goals or cost functions search the graph instead of generating successors and checking invariants.
+    // The graph holds all successors: ample sets, chain compression and the memory budget do not apply to searches over it.
+    // It is built by the first query without a token, progress callback or memory budget (which are not applied while
+    // building it); until then such queries search as without caching.
+    void cache_graph(bool enable = true)
+    {
+        graph_caching = enable;
+        if (!enable)
+            graph_cache.reset();
+    }
+
+    // Caches the given graph, which must be the reachable graph of this state space. A graph file is searched in place by
+    // check_graph and explore_graph instead, csr_graph_t::to_state_graph copies all of it.
+    void use_graph(std::shared_ptr<const state_graph_t<State_t>> graph)
+    {
+        graph_caching = true;
+        graph_cache = std::move(graph);
+    }
+
+    // Replaces the cost function, e.g. to query a cached graph by another cost
+    void use_cost_function(const Cost_fn &cost_fn) { cost_function = cost_fn; }
+
+    // The reachable state graph, explored now unless it is cached
+    std::shared_ptr<const state_graph_t<State_t>> graph()
+    {
+        if (graph_cache)
+            return graph_cache;
+        auto graph = std::make_shared<const state_graph_t<State_t>>(build_graph());
+        if (graph_caching)
+            graph_cache = graph;
+        return graph;
+    }
+
+    // Searches for a goal state, filling statistics with counters and per-phase wall times
+    auto check(const std::function<bool(const State_t &)> &goal_pred, const search_order_t &search_order, search_statistics_t &statistics)
+    {
+        auto result = search(goal_pred, search_order, statistics, nullptr);
+        if (result.status == search_status_t::solved)
+            return std::move(result.solution);
+        if (!statistics.complete)
+            throw new std::logic_error("No solution found within the memory budget, the search was incomplete");
+        throw new std::logic_error("No solution could be found");
+    }
+
     auto check(const std::function<bool(const State_t &)> &goal_pred, const search_order_t &search_order = search_order_t::breadth_first)
     {
-        Timer timer;
-        // Waiting holds all states waiting to be visited
-        std::deque<State_t> waiting{initial_state};
-        // Passed holds all states already visited
-        std::vector<State_t> passed{};
-        // Trace maps a state to its successor, s.t. the final solution can be computed from the trace
-        std::map<State_t, State_t> trace{};
+        search_statistics_t statistics{};
+        return check(goal_pred, search_order, statistics);
+    }
+
+    // Searches for any of the given goal states. Goal states violating the invariant cannot be reached,
+    // so if no goal state upholds it, the search fails without exploring anything.
+    auto check(const goal_set_t<State_t> &goals, const search_order_t &search_order, search_statistics_t &statistics)
+    {
+        if (std::none_of(goals.begin(), goals.end(), [this](const State_t &state) { return invariant(state); }))
+        {
+            statistics = search_statistics_t{};
+            throw new std::logic_error("No solution could be found");
+        }
+        return check(std::function<bool(const State_t &)>{goals}, search_order, statistics);
+    }
+
+    auto check(const goal_set_t<State_t> &goals, const search_order_t &search_order = search_order_t::breadth_first)
+    {
+        search_statistics_t statistics{};
+        return check(goals, search_order, statistics);
+    }
+
+    // Distances to the nearest of the given goal states
+    distance_table_t<State_t> goal_distances(const goal_set_t<State_t> &goals)
+    {
+        return goal_distances(std::function<bool(const State_t &)>{goals});
+    }
+
+    // Searches for a goal state until the token is cancelled or its deadline passes, and returns the partial result then
+    // instead of throwing. Cost guided search is anytime: it keeps searching after a goal and replaces the solution
+    // whenever it reaches a goal by a cheaper path (cost_function applied along the path). A cheaper path to a state
+    // reached before relinks it and searches on from it, so once the search ends on its own the solution is the cheapest,
+    // provided that costs do not decrease along a path and the store stayed exact (see search_statistics_t::complete).
+    // It keeps the cost of every reached state besides the store.
+    search_result_t<State_t> check(const std::function<bool(const State_t &)> &goal_pred, const search_order_t &search_order,
+                                   const cancellation_token_t &token, search_statistics_t &statistics)
+    {
+        return search(goal_pred, search_order, statistics, &token);
+    }
+
+    search_result_t<State_t> check(const std::function<bool(const State_t &)> &goal_pred, const search_order_t &search_order, const cancellation_token_t &token)
+    {
+        search_statistics_t statistics{};
+        return check(goal_pred, search_order, token, statistics);
+    }
+
+    // Searches the given graph instead of generating successors: a state_graph_t or a graph file mapped by csr_graph_t,
+    // which is read in place. It must be the reachable graph of this state space, with the initial states first.
+    template <typename Graph_t>
+    std::list<State_t> check_graph(const Graph_t &graph, const std::function<bool(const State_t &)> &goal_pred, const search_order_t &search_order,
+                                   search_statistics_t &statistics)
+    {
+        PROFILE_ZONE("check");
+        statistics = search_statistics_t{};
+        search_result_t<State_t> result{};
+        {
+            scoped_duration_t total{statistics.time.total};
+            result = search_graph(graph, goal_pred, search_order, statistics, nullptr, {}, {});
+        }
+        if (result.status != search_status_t::solved)
+            throw new std::logic_error("No solution could be found");
+        return std::move(result.solution);
+    }
+
+    template <typename Graph_t>
+    std::list<State_t> check_graph(const Graph_t &graph, const std::function<bool(const State_t &)> &goal_pred,
+                                   const search_order_t &search_order = search_order_t::breadth_first)
+    {
+        search_statistics_t statistics{};
+        return check_graph(graph, goal_pred, search_order, statistics);
+    }
+
+    // Runs check with the token on the engine's thread pool (search_pool), searching a copy of this state space so that
+    // concurrent queries share nothing. The progress callback is called from the worker at most once per interval
+    // (the clock is read every 64 expansions), never per state.
+    std::future<search_result_t<State_t>> check_async(std::function<bool(const State_t &)> goal_pred, search_order_t search_order = search_order_t::breadth_first,
+                                                      cancellation_token_t token = {}, progress_callback_t progress = {},
+                                                      std::chrono::milliseconds interval = std::chrono::milliseconds{100}) const
+    {
+        return search_pool().submit([space = *this, goal_pred = std::move(goal_pred), search_order, token = std::move(token),
+                                     progress = std::move(progress), interval]() mutable {
+            search_statistics_t statistics{};
+            return space.search(goal_pred, search_order, statistics, &token, progress, interval);
+        });
+    }
+
+#if defined(__cpp_impl_coroutine)
+    // The search of check with the token as a coroutine suspending after every slice of expansions, for search_scheduler_t
+    // to interleave many searches on few threads. It searches a copy of this state space. Only the slices are timed,
+    // and neither hardware events nor allocations are counted, as consecutive slices may run on different threads.
+    search_task_t<search_result_t<State_t>> check_coroutine(std::function<bool(const State_t &)> goal_pred, search_order_t search_order = search_order_t::breadth_first,
+                                                            std::size_t slice = 1024, cancellation_token_t token = {}) const
+    {
+        auto task = run_coroutine(*this, std::move(goal_pred), search_order, slice, token);
+        task.token = std::move(token);
+        return task;
+    }
+#endif
+
+    // Searches for several named goals at once: the search goes on until every goal has been reached or the state space
+    // is exhausted, sharing waiting and the trace (or the cached graph, see cache_graph). Returns a solution for every goal reached, unreachable goals are absent
+    // (or may have been missed, if statistics.complete is false).
+    std::map<std::string, std::list<State_t>> check_goals(const std::map<std::string, std::function<bool(const State_t &)>> &goals,
+                                                          const search_order_t &search_order, search_statistics_t &statistics)
+    {
+        PROFILE_ZONE("check");
+        statistics = search_statistics_t{};
+        scoped_perf_counters_t counters{hardware_counting, statistics.hardware};
+        scoped_duration_t total{statistics.time.total};
+        scoped_allocation_counting_t allocations{statistics.allocations};
+        std::map<std::string, std::list<State_t>> solutions{};
+        // Goals already reached are no longer searched for, so chains are not cut at them either
+        std::function<bool(const State_t &)> any_goal = [&](const State_t &state) {
+            return std::any_of(goals.begin(), goals.end(), [&](const auto &goal) { return solutions.count(goal.first) == 0 && goal.second(state); });
+        };
+        if (searches_graph(budget != std::numeric_limits<std::size_t>::max()))
+        {
+            search_graph(*graph(), any_goal, search_order, statistics, nullptr, {}, {}, [&](const std::list<State_t> &solution) {
+                for (auto &[name, goal_pred] : goals)
+                    if (solutions.count(name) == 0 && goal_pred(solution.back()))
+                        solutions.emplace(name, solution);
+                return solutions.size() < goals.size();
+            });
+            return solutions;
+        }
+        search_run_t run{*this, any_goal, search_order, statistics, nullptr, {}, {}};
+        run.on_goal([&](const State_t &state) {
+            std::optional<std::list<State_t>> solution{};
+            for (auto &[name, goal_pred] : goals)
+                if (solutions.count(name) == 0 && goal_pred(state))
+                {
+                    if (!solution)
+                        solution = run.trace(state);
+                    solutions.emplace(name, *solution);
+                }
+        });
+        while (solutions.size() < goals.size() && run.step())
+            ;
+        run.finish();
+        return solutions;
+    }
+
+    std::map<std::string, std::list<State_t>> check_goals(const std::map<std::string, std::function<bool(const State_t &)>> &goals,
+                                                          const search_order_t &search_order = search_order_t::breadth_first)
+    {
+        search_statistics_t statistics{};
+        return check_goals(goals, search_order, statistics);
+    }
+
+    // Finds all optimal solutions in one search by recording every equally cheap parent of each state.
+    // Cost guided search minimises the path cost (cost_function applied along the path), the other orders the path length.
+    // Parents are only recorded while a state is still open, so zero-cost cycles cannot make the solution graph cyclic.
+    solution_dag_t<State_t> check_all(const std::function<bool(const State_t &)> &goal_pred, const search_order_t &search_order = search_order_t::breadth_first)
+    {
+        if (graph_cache)
+            return search_order == search_order_t::cost_guided ? check_all_cheapest(*graph_cache, goal_pred) : check_all_shortest(*graph_cache, goal_pred);
+        generated_graph_t graph{*this};
+        return search_order == search_order_t::cost_guided ? check_all_cheapest(graph, goal_pred) : check_all_shortest(graph, goal_pred);
+    }
+
+    // Finds up to k loopless solutions in increasing cost order (Yen's algorithm) over the graph explored once.
+    // Cost guided search orders by path cost (cost_function applied along the path), the other orders by path length.
+    std::vector<std::list<State_t>> check_k_shortest(const std::function<bool(const State_t &)> &goal_pred, std::size_t k, const search_order_t &search_order = search_order_t::breadth_first)
+    {
+        auto shared_graph = graph();
+        const auto &graph = *shared_graph;
+        std::vector<bool> goals(graph.states.size());
+        for (auto i = 0u; i < graph.states.size(); ++i)
+            goals[i] = goal_pred(graph.states[i]);
+        // The k cheapest solutions are among the k cheapest from each initial state
+        auto k_shortest = [&](const auto &start_cost, const auto &fold) {
+            std::multimap<std::decay_t<decltype(start_cost)>, std::vector<std::size_t>> candidates{};
+            for (std::size_t source = 0; source < initial_states.size(); ++source)
+                for (auto &path : yen(graph, goals, k, source, start_cost, fold))
+                {
+                    auto cost = start_cost;
+                    for (auto node = std::next(path.begin()); node != path.end(); ++node)
+                        cost = fold(*node, cost);
+                    candidates.emplace(cost, std::move(path));
+                }
+            std::vector<std::vector<std::size_t>> paths{};
+            for (auto candidate = candidates.begin(); candidate != candidates.end() && paths.size() < k; ++candidate)
+                paths.push_back(std::move(candidate->second));
+            return paths;
+        };
+        std::vector<std::vector<std::size_t>> paths{};
+        if (search_order == search_order_t::cost_guided)
+            paths = k_shortest(initial_cost, [&graph, this](std::size_t node, const Cost_t &prev) { return cost_function(graph.states[node], prev); });
+        else
+            paths = k_shortest(std::size_t{0}, [](std::size_t, std::size_t prev) { return prev + 1; });
+        std::vector<std::list<State_t>> solutions{};
+        for (auto &path : paths)
+        {
+            solutions.emplace_back();
+            for (auto node : path)
+                solutions.back().push_back(graph.states[node]);
+        }
+        return solutions;
+    }
+
+    // Distances to the nearest goal state of all reachable states, by one breadth first search backwards from the goal
+    // states over the reversed edges of the reachable graph (cached or explored now)
+    distance_table_t<State_t> goal_distances(const std::function<bool(const State_t &)> &goal_pred)
+    {
+        auto shared_graph = graph();
+        const auto &graph = *shared_graph;
+        // Reversed edges in compressed sparse row form
+        std::vector<std::size_t> offsets(graph.states.size() + 1);
+        for (auto &edges : graph.edges)
+            for (auto succ : edges)
+                ++offsets[succ + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::size_t> predecessors(offsets.back());
+        auto fill = offsets;
+        for (auto node = 0u; node < graph.edges.size(); ++node)
+            for (auto succ : graph.edges[node])
+                predecessors[fill[succ]++] = node;
+
+        constexpr auto unknown = std::numeric_limits<std::uint32_t>::max();
+        std::vector<std::uint32_t> distance(graph.states.size(), unknown);
+        std::deque<std::size_t> waiting{};
+        for (auto node = 0u; node < graph.states.size(); ++node)
+            if (goal_pred(graph.states[node]))
+            {
+                distance[node] = 0;
+                waiting.push_back(node);
+            }
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> entries{};
         while (!waiting.empty())
         {
-            State_t curr_state = popstate(waiting, search_order);
-            if (goal_pred(curr_state))
-                return get_solution_from_trace(trace, curr_state);
+            auto node = waiting.front();
+            waiting.pop_front();
+            entries.emplace_back(state_hash(graph.states[node]), distance[node]);
+            for (auto i = offsets[node]; i < offsets[node + 1]; ++i)
+                if (distance[predecessors[i]] == unknown)
+                {
+                    distance[predecessors[i]] = distance[node] + 1;
+                    waiting.push_back(predecessors[i]);
+                }
+        }
+        return distance_table_t<State_t>{std::move(entries)};
+    }
+
+    // A shortest solution from start (a state of this state space) read off the distance table without searching:
+    // each step goes to a successor one step closer to a goal
+    std::list<State_t> check_distances(const distance_table_t<State_t> &distances, const State_t &start)
+    {
+        auto distance = distances.distance(start);
+        if (!distance)
+            throw new std::logic_error("No solution could be found");
+        std::list<State_t> solution{start};
+        for (; *distance > 0; --*distance)
+        {
+            auto succs = valid_successors(solution.back());
+            auto next = std::find_if(succs.begin(), succs.end(), [&](const State_t &succ) { return distances.distance(succ) == *distance - 1; });
+            if (next == succs.end())
+                throw new std::logic_error("The distance table does not belong to this state space");
+            solution.push_back(std::move(*next));
+        }
+        return solution;
+    }
+
+    std::list<State_t> check_distances(const distance_table_t<State_t> &distances) { return check_distances(distances, initial_states.front()); }
+
+    // Enumerates the whole reachable state space layer by layer without keeping a trace
+    exploration_t explore()
+    {
+        if (graph_caching)
+            return explore_graph(*graph());
+        exploration_t result{};
+        // Every reached state, hashed by its fingerprint and without the parent the search's store keeps for its trace
+        std::unordered_set<State_t, state_hasher, state_equal> passed{initial_states.begin(), initial_states.end()};
+        std::vector<State_t> layer{initial_states};
+        while (!layer.empty())
+        {
+            result.layers.push_back(layer.size());
+            std::vector<State_t> next_layer{};
+            for (auto &state : layer)
+            {
+                auto succs = valid_successors(state);
+                if (succs.empty())
+                    ++result.terminal;
+                for (auto &succ : succs)
+                    if (passed.insert(succ).second)
+                        next_layer.push_back(std::move(succ));
+            }
+            layer = std::move(next_layer);
+        }
+        result.states = passed.size();
+        result.depth = result.layers.size() - 1;
+        return result;
+    }
+
+    // The exploration of explore over the given graph, the cached one or a graph file read in place (see check_graph)
+    template <typename Graph_t>
+    exploration_t explore_graph(const Graph_t &graph)
+    {
+        exploration_t result{};
+        std::vector<bool> passed(graph.size());
+        std::vector<std::size_t> layer(initial_states.size());
+        std::iota(layer.begin(), layer.end(), std::size_t{0});
+        std::fill(passed.begin(), passed.begin() + layer.size(), true);
+        while (!layer.empty())
+        {
+            result.layers.push_back(layer.size());
+            std::vector<std::size_t> next_layer{};
+            for (auto node : layer)
+            {
+                if (graph.successors(node).empty())
+                    ++result.terminal;
+                for (auto succ : graph.successors(node))
+                    if (!passed[succ])
+                    {
+                        passed[succ] = true;
+                        next_layer.push_back(succ);
+                    }
+            }
+            layer = std::move(next_layer);
+        }
+        result.states = graph.size();
+        result.depth = result.layers.size() - 1;
+        return result;
+    }
+
+private:
+    // One search in progress: the loop behind check, advanced one popped state at a time so that it can be interleaved.
+    // It stops at the first goal, or without a token when the search space or budget is exhausted. With a token it polls
+    // the token at every expansion (its deadline every 64), and cost guided search continues past goals and reopens
+    // states reached again by a cheaper path (see relax).
+    // Progress is reported at most once per interval, from the same clock reads.
+    class search_run_t
+    {
+        state_space_t &space;
+        const std::function<bool(const State_t &)> &goal_pred;
+        search_order_t search_order;
+        search_statistics_t &statistics;
+        const cancellation_token_t *token;
+        progress_callback_t progress; // a copy, callers may pass a temporary
+        std::chrono::milliseconds interval;
+        // Waiting holds all states waiting to be visited
+        std::deque<State_t> waiting;
+        // Store holds all states waiting or passed, and the trace from which the final solution can be computed
+        search_store_t<State_t> store;
+        search_result_t<State_t> result{};
+        bool anytime;
+        std::optional<Cost_t> best_cost{};
+        // Anytime search: the cost of the cheapest path found to every stored state, and whether it is waiting
+        struct label_t
+        {
+            Cost_t cost;
+            bool queued;
+        };
+        std::unordered_map<State_t, label_t, state_hasher, state_equal> labels{};
+        std::chrono::steady_clock::time_point next_report;
+        std::function<void(const State_t &)> goal_reached{};
+        // Successors of the states being expanded and their fingerprints, reused from one expansion to the next
+        std::vector<const State_t *> batch{};
+        std::vector<std::uint64_t> fingerprints{};
+
+        // A waiting state of a batch (see step_batch): whether it is a goal, and its successors
+        using successors_t = decltype(std::declval<Successor_gen &>()(std::declval<const State_t &>()));
+        struct expansion_t
+        {
+            bool goal;
+            successors_t successors;
+        };
+        static constexpr std::size_t batch_states = 32;
+        std::vector<expansion_t> expansions{};
+
+        // A state is valid if it upholds the invariant, and unseen if it is neither in waiting nor passed
+        bool valid(const State_t &succ)
+        {
+            PROFILE_ZONE("invariant");
+            scoped_duration_t phase{space.phase_time(statistics.time.invariant)};
+            return space.invariant(succ);
+        }
+
+        bool unseen(const State_t &succ, std::uint64_t fingerprint)
+        {
+            scoped_duration_t phase{space.phase_time(statistics.time.dedup)};
+            return !store.contains(succ, fingerprint);
+        }
+
+        bool unseen(const State_t &succ) { return unseen(succ, state_hash(succ)); }
+
+        // The fingerprints of all successors at once (see state_batch.hpp), to probe and fill the store with
+        template <typename Successors>
+        void fingerprint(const Successors &successors)
+        {
+            scoped_duration_t phase{space.phase_time(statistics.time.dedup)};
+            batch.clear();
+            for (auto &succ : successors)
+                batch.push_back(&succ);
+            fingerprints.resize(batch.size());
+            state_hashes(batch.data(), batch.size(), fingerprints.data());
+        }
+
+        State_t pop()
+        {
+            PROFILE_ZONE("popstate");
+            scoped_duration_t phase{space.phase_time(statistics.time.frontier)};
+            return space.popstate(waiting, search_order);
+        }
+
+        successors_t generate(const State_t &state)
+        {
+            PROFILE_ZONE("successors");
+            scoped_duration_t phase{space.phase_time(statistics.time.generation)};
+            return space.successors_function(state);
+        }
+
+        // What becomes of a popped state, see visit
+        enum class visit_t
+        {
+            expand,
+            skip, // a goal of anytime search
+            end
+        };
+
+        // Handles a popped state up to its expansion: ends the search at a goal (anytime search keeps the cheapest
+        // solution and skips it) or when cancelled, putting the state back so that it counts as the frontier
+        visit_t visit(State_t &curr_state, bool goal)
+        {
+            store.pop(curr_state);
+            if (anytime)
+                labels.at(curr_state).queued = false;
+            if (goal && goal_reached)
+                goal_reached(curr_state);
+            else if (goal)
+            {
+                auto solution = trace(curr_state);
+                result.status = search_status_t::solved;
+                if (!anytime)
+                {
+                    result.solution = std::move(solution);
+                    return visit_t::end;
+                }
+                auto cost = space.solution_cost(solution);
+                if (!best_cost || cost < *best_cost)
+                {
+                    best_cost = cost;
+                    result.solution = std::move(solution);
+                }
+                if (cancelled())
+                {
+                    result.status = search_status_t::cancelled;
+                    return visit_t::end;
+                }
+                return visit_t::skip;
+            }
+            if (cancelled())
+            {
+                waiting.push_front(std::move(curr_state));
+                result.status = search_status_t::cancelled;
+                return visit_t::end;
+            }
+            ++statistics.expanded;
+            report(curr_state);
+            return visit_t::expand;
+        }
+
+        // Adds the successors of the expanded state with their fingerprints, returns false if the budget is exhausted
+        template <typename Successors>
+        bool expand(const State_t &curr_state, Successors &successors, const std::uint64_t *succ_fingerprints)
+        {
+            auto is_valid = [this](const State_t &succ) { return valid(succ); };
+            auto is_unseen = [this](const State_t &succ, std::uint64_t fingerprint) { return unseen(succ, fingerprint); };
+            auto reached = [this, &curr_state](const State_t &succ, bool discovered) {
+                if (anytime)
+                    relax(curr_state, succ, discovered);
+            };
+            space.add_successors(successors, succ_fingerprints, curr_state, waiting, store, is_valid, is_unseen, goal_pred, statistics, reached);
+            statistics.peak_frontier = std::max(statistics.peak_frontier, waiting.size());
+            statistics.peak_visited = std::max(statistics.peak_visited, store.size());
+            if (!store.fits(waiting.size()))
+            {
+                statistics.complete = false;
+                result.status = search_status_t::out_of_memory;
+                return false;
+            }
+            return true;
+        }
+
+        // Anytime search: records the cost of the path to a successor of the expanded state. A cheaper path to a stored
+        // state relinks it in the store and queues it again, so that its successors and the goals behind it are reached by
+        // the cheaper path too. Relinking needs the exact regime. A path through the state itself is never cheaper unless
+        // costs decrease along a path, it is skipped so that the trace stays a tree.
+        void relax(const State_t &curr_state, const State_t &succ, bool discovered)
+        {
+            auto cost = space.cost_function(succ, labels.at(curr_state).cost);
+            if (discovered)
+            {
+                labels.insert_or_assign(succ, label_t{cost, true});
+                return;
+            }
+            auto label = labels.find(succ);
+            if (label == labels.end() || !(cost < label->second.cost) || store.regime() != storage_regime_t::exact)
+                return;
+            auto path = store.state_path(curr_state);
+            if (std::any_of(path.begin(), path.end(), [&succ](const State_t &state) { return state_equal{}(state, succ); }))
+                return;
+            store.reparent(succ, curr_state);
+            label->second.cost = cost;
+            if (!label->second.queued)
+            {
+                label->second.queued = true;
+                waiting.push_back(succ);
+            }
+        }
+
+        // Processes a batch of states as step does one at a time, in the same order and with the same result. Breadth
+        // first order expands the states that were waiting before any of their successors, so it can generate and
+        // fingerprint the successors of all of them first and prefetch their slots in the store. The cache misses of
+        // the probes then overlap instead of stalling one successor at a time. The states stay waiting until they are
+        // popped one by one, so that the frontier, cancellation and the budget see them as step would.
+        bool step_batch()
+        {
+            if (waiting.empty())
+                return false;
+            try
+            {
+                expansions.clear();
+                for (auto count = std::min(batch_states, waiting.size()); expansions.size() < count;)
+                {
+                    auto &state = waiting[expansions.size()];
+                    auto goal = goal_pred(state);
+                    expansions.push_back(expansion_t{goal, {}});
+                    if (goal && !goal_reached)
+                        break; // ends the search once the states before it are expanded
+                    expansions.back().successors = generate(state);
+                }
+                {
+                    scoped_duration_t phase{space.phase_time(statistics.time.dedup)};
+                    batch.clear();
+                    for (auto &expansion : expansions)
+                        for (auto &succ : expansion.successors)
+                            batch.push_back(&succ);
+                    fingerprints.resize(batch.size());
+                    state_hashes(batch.data(), batch.size(), fingerprints.data());
+                    for (auto fingerprint : fingerprints)
+                        store.prefetch(fingerprint);
+                }
+                auto succ_fingerprints = fingerprints.data();
+                for (auto &expansion : expansions)
+                {
+                    auto curr_state = pop();
+                    auto visited = visit(curr_state, expansion.goal);
+                    if (visited == visit_t::end || (visited == visit_t::expand && !expand(curr_state, expansion.successors, succ_fingerprints)))
+                        return false;
+                    succ_fingerprints += expansion.successors.size();
+                }
+            }
+            catch (const std::bad_alloc &)
+            {
+                statistics.complete = false;
+                result.status = search_status_t::out_of_memory;
+                return false;
+            }
+            return true;
+        }
+
+        bool cancelled() const
+        {
+            return token && (token->cancel_requested() || (statistics.expanded % 64 == 0 && token->expired()));
+        }
+
+        void report(const State_t &curr_state)
+        {
+            if (!progress || statistics.expanded % 64 != 0 || std::chrono::steady_clock::now() < next_report)
+                return;
+            next_report = std::chrono::steady_clock::now() + interval;
+            progress(search_progress_t{statistics.expanded, waiting.size(), store.depth(curr_state)});
+        }
+
+    public:
+        search_run_t(state_space_t &space, const std::function<bool(const State_t &)> &goal_pred, search_order_t search_order,
+                     search_statistics_t &statistics, const cancellation_token_t *token, progress_callback_t progress,
+                     std::chrono::milliseconds interval)
+            : space{space},
+              goal_pred{goal_pred},
+              search_order{search_order},
+              statistics{statistics},
+              token{token},
+              progress{std::move(progress)},
+              interval{interval},
+              waiting{space.initial_states.begin(), space.initial_states.end()},
+              store{space.initial_states, space.budget},
+              anytime{token && search_order == search_order_t::cost_guided},
+              next_report{std::chrono::steady_clock::now() + interval}
+        {
+            space.previous_cost = space.initial_cost;
+            space.compressing = space.chain_compression && search_order == search_order_t::depth_first;
+            if (anytime)
+                for (auto &state : space.initial_states)
+                    labels.emplace(state, label_t{space.initial_cost, true});
+        }
 
-            // If the current state is not in passed, add it to passed
-            passed.push_back(curr_state);
-            // Iterate through all successors
-            for (auto &succ : successors_function(curr_state)) //Could have used const iterator
+        // Instead of ending at a goal state, calls back and expands it as any other state
+        void on_goal(std::function<void(const State_t &)> callback) { goal_reached = std::move(callback); }
+
+        // The solution ending in a stored state (in bitstate regime: the last popped or a waiting state)
+        std::list<State_t> trace(const State_t &state)
+        {
+            scoped_duration_t phase{statistics.time.trace};
+            return space.get_solution_from_trace(store, state);
+        }
+
+        // Pops and processes one state (or a batch, see step_batch), returns false when the search has ended
+        bool step()
+        {
+            if constexpr (!is_ample_set<successors_t>::value)
+                if (search_order == search_order_t::breadth_first)
+                    return step_batch();
+            if (waiting.empty())
+                return false;
+            try
             {
-                // If the state upholds the invariant and is neither in waiting nor passed, add it to trace and waiting
-                if (invariant(succ) && std::find(waiting.begin(), waiting.end(), succ) == waiting.end() && std::find(passed.begin(), passed.end(), succ) == passed.end())
+                State_t curr_state = pop();
+                auto visited = visit(curr_state, goal_pred(curr_state));
+                if (visited != visit_t::expand)
+                    return visited == visit_t::skip;
+                auto all_successors = generate(curr_state);
+                if constexpr (is_ample_set<decltype(all_successors)>::value)
                 {
-                    trace[succ] = curr_state;
+                    auto &expanded = ample_proviso(all_successors, [&](const State_t &succ) { return valid(succ) && unseen(succ); });
+                    fingerprint(expanded);
+                    return expand(curr_state, expanded, fingerprints.data());
+                }
+                else
+                {
+                    fingerprint(all_successors);
+                    return expand(curr_state, all_successors, fingerprints.data());
+                }
+            }
+            catch (const std::bad_alloc &)
+            {
+                statistics.complete = false;
+                result.status = search_status_t::out_of_memory;
+                return false;
+            }
+        }
+
+        // The result once step has returned false
+        search_result_t<State_t> finish()
+        {
+            if (!result.solution.empty() && result.status != search_status_t::cancelled)
+                result.status = search_status_t::solved; // anytime search ran to the end
+            statistics.regime = store.regime();
+            statistics.bytes_per_state = store.bytes(waiting.size()) / store.size();
+            if (store.regime() != storage_regime_t::exact)
+                statistics.complete = false; // fingerprint or bitstate collisions may have pruned states
+            result.explored = statistics.expanded;
+            if (token && result.solution.empty() && !waiting.empty())
+            {
+                // Report how far the search got: the path to the waiting state the cost guided order would pop next
+                scoped_duration_t phase{statistics.time.trace};
+                auto cheapest = std::min_element(waiting.begin(), waiting.end(), [this](const State_t &a, const State_t &b) {
+                    return space.cost_function(a, space.previous_cost) < space.cost_function(b, space.previous_cost);
+                });
+                result.frontier = space.get_solution_from_trace(store, *cheapest);
+            }
+            return std::move(result);
+        }
+    };
+
+    search_result_t<State_t> search(const std::function<bool(const State_t &)> &goal_pred, const search_order_t &search_order,
+                                    search_statistics_t &statistics, const cancellation_token_t *token,
+                                    const progress_callback_t &progress = {}, std::chrono::milliseconds interval = {})
+    {
+        PROFILE_ZONE("check");
+        statistics = search_statistics_t{};
+        scoped_perf_counters_t counters{hardware_counting, statistics.hardware};
+        scoped_duration_t total{statistics.time.total};
+        scoped_allocation_counting_t allocations{statistics.allocations};
+        if (searches_graph(token || progress || budget != std::numeric_limits<std::size_t>::max()))
+            return search_graph(*graph(), goal_pred, search_order, statistics, token, progress, interval);
+        search_run_t run{*this, goal_pred, search_order, statistics, token, progress, interval};
+        while (run.step())
+            ;
+        return run.finish();
+    }
+
+    // Whether a query searches the cached graph, building it first if need be. Building the graph neither polls a token,
+    // reports progress nor keeps to the budget, so a bounded query runs as without caching until a graph is cached.
+    bool searches_graph(bool bounded) const noexcept { return graph_caching && (graph_cache || !bounded); }
+
+#if defined(__cpp_impl_coroutine)
+    static search_task_t<search_result_t<State_t>> run_coroutine(state_space_t space, std::function<bool(const State_t &)> goal_pred,
+                                                                 search_order_t search_order, std::size_t slice, cancellation_token_t token)
+    {
+        search_statistics_t statistics{};
+        search_run_t run{space, goal_pred, search_order, statistics, &token, {}, {}};
+        for (auto running = true; running;)
+        {
+            {
+                scoped_duration_t total{statistics.time.total};
+                for (auto end = statistics.expanded + slice; running && statistics.expanded < end;)
+                    running = run.step();
+            }
+            if (running)
+                co_yield statistics.expanded;
+        }
+        co_return run.finish();
+    }
+#endif
+
+    // The search of check over a graph: the same orders and results, over state indices instead of states.
+    // With goal_reached, a goal state is expanded as any other state after it is called with the path to it (see
+    // search_run_t::on_goal), and the search ends once it returns false.
+    template <typename Graph_t>
+    search_result_t<State_t> search_graph(const Graph_t &graph, const std::function<bool(const State_t &)> &goal_pred,
+                                          const search_order_t &search_order, search_statistics_t &statistics, const cancellation_token_t *token,
+                                          const progress_callback_t &progress, std::chrono::milliseconds interval,
+                                          const std::function<bool(const std::list<State_t> &)> &goal_reached = {})
+    {
+        constexpr auto unseen = std::numeric_limits<std::size_t>::max();
+        // The index of the state each state was reached from (itself for the initial states), unseen if it was not
+        std::vector<std::size_t> parent(graph.size(), unseen);
+        std::deque<std::size_t> waiting{};
+        for (std::size_t root = 0; root < initial_states.size(); ++root)
+        {
+            parent[root] = root;
+            waiting.push_back(root);
+        }
+        std::size_t visited = waiting.size();
+        search_result_t<State_t> result{};
+        auto anytime = token && search_order == search_order_t::cost_guided;
+        std::optional<Cost_t> best_cost{};
+        // Anytime search: the cost of the cheapest path found to every reached state, and whether it is waiting
+        std::vector<std::optional<Cost_t>> cost(anytime ? graph.size() : 0);
+        std::vector<bool> queued(anytime ? graph.size() : 0);
+        if (anytime)
+            for (auto root : waiting)
+            {
+                cost[root] = initial_cost;
+                queued[root] = true;
+            }
+        auto next_report = std::chrono::steady_clock::now() + interval;
+        previous_cost = initial_cost;
+        auto path = [&](std::size_t node) {
+            scoped_duration_t phase{statistics.time.trace};
+            std::list<State_t> path{graph.state(node)};
+            for (; parent[node] != node; node = parent[node])
+                path.push_front(graph.state(parent[node]));
+            return path;
+        };
+        auto cheapest = [&] {
+            return std::min_element(waiting.begin(), waiting.end(), [this, &graph](std::size_t a, std::size_t b) {
+                return cost_function(graph.state(a), previous_cost) < cost_function(graph.state(b), previous_cost);
+            });
+        };
+        auto cancelled = [&] {
+            return token && (token->cancel_requested() || (statistics.expanded % 64 == 0 && token->expired()));
+        };
+        // Anytime search: relinks a reached state to node if that path is cheaper, and queues it again (see search_run_t::relax)
+        auto relax = [&](std::size_t node, std::size_t succ) {
+            auto succ_cost = cost_function(graph.state(succ), *cost[node]);
+            if (!(succ_cost < *cost[succ]))
+                return;
+            for (auto ancestor = node;; ancestor = parent[ancestor])
+            {
+                if (ancestor == succ)
+                    return;
+                if (parent[ancestor] == ancestor)
+                    break;
+            }
+            parent[succ] = node;
+            cost[succ] = succ_cost;
+            if (!queued[succ])
+            {
+                queued[succ] = true;
+                waiting.push_back(succ);
+            }
+        };
+        while (!waiting.empty())
+        {
+            std::size_t node;
+            {
+                scoped_duration_t phase{phase_time(statistics.time.frontier)};
+                auto next = search_order == search_order_t::depth_first ? std::prev(waiting.end())
+                          : search_order == search_order_t::breadth_first ? waiting.begin()
+                                                                          : cheapest();
+                if (search_order == search_order_t::cost_guided)
+                    previous_cost = cost_function(graph.state(*next), previous_cost);
+                node = *next;
+                waiting.erase(next);
+            }
+            if (anytime)
+                queued[node] = false;
+            auto goal = goal_pred(graph.state(node));
+            if (goal && goal_reached)
+            {
+                if (!goal_reached(path(node)))
+                    break;
+            }
+            else if (goal)
+            {
+                result.status = search_status_t::solved;
+                auto solution = path(node);
+                if (!anytime)
+                {
+                    result.solution = std::move(solution);
+                    break;
+                }
+                auto cost = solution_cost(solution);
+                if (!best_cost || cost < *best_cost)
+                {
+                    best_cost = cost;
+                    result.solution = std::move(solution);
+                }
+                if (cancelled())
+                {
+                    result.status = search_status_t::cancelled;
+                    break;
+                }
+                continue;
+            }
+            if (cancelled())
+            {
+                waiting.push_front(node);
+                result.status = search_status_t::cancelled;
+                break;
+            }
+            ++statistics.expanded;
+            if (progress && statistics.expanded % 64 == 0 && std::chrono::steady_clock::now() >= next_report)
+            {
+                next_report = std::chrono::steady_clock::now() + interval;
+                progress(search_progress_t{statistics.expanded, waiting.size(), path(node).size() - 1});
+            }
+            for (auto succ : graph.successors(node))
+            {
+                ++statistics.generated;
+                if (parent[succ] != unseen)
+                {
+                    ++statistics.deduplicated;
+                    if (anytime)
+                        relax(node, succ);
+                }
+                else
+                {
+                    parent[succ] = node;
+                    ++visited;
                     waiting.push_back(succ);
+                    if (anytime)
+                    {
+                        cost[succ] = cost_function(graph.state(succ), *cost[node]);
+                        queued[succ] = true;
+                    }
                 }
             }
+            statistics.peak_frontier = std::max(statistics.peak_frontier, waiting.size());
+            statistics.peak_visited = std::max(statistics.peak_visited, visited);
         }
-        throw new std::logic_error("No solution could be found");
+        if (!result.solution.empty() && result.status != search_status_t::cancelled)
+            result.status = search_status_t::solved;
+        result.explored = statistics.expanded;
+        statistics.bytes_per_state = sizeof(std::size_t); // the parent index, the states belong to the graph
+        if (token && result.solution.empty() && !waiting.empty())
+            result.frontier = path(*cheapest());
+        return result;
+    }
+
+    // The duration to add a phase's time to, null (not timed) unless phases are timed
+    std::chrono::nanoseconds *phase_time(std::chrono::nanoseconds &duration) const noexcept { return phase_timing ? &duration : nullptr; }
+
+    // Cost of a path: cost_function applied along it from the initial cost
+    Cost_t solution_cost(const std::list<State_t> &path)
+    {
+        auto cost = initial_cost;
+        for (auto state = std::next(path.begin()); state != path.end(); ++state)
+            cost = cost_function(*state, cost);
+        return cost;
+    }
+
+    // Adds the new valid successors, whose fingerprints are given in the same order, to the store and waiting.
+    // Reached is called with every valid successor (a new one: the end of its chain) and whether it is new.
+    template <typename Successors, typename Valid, typename Unseen, typename Reached>
+    void add_successors(Successors &all_successors, const std::uint64_t *fingerprints, const State_t &curr_state,
+                        std::deque<State_t> &waiting, search_store_t<State_t> &store, const Valid &valid, const Unseen &unseen,
+                        const std::function<bool(const State_t &)> &goal_pred, search_statistics_t &statistics, const Reached &reached)
+    {
+        auto is_new = [&](const State_t &succ) { return valid(succ) && unseen(succ, state_hash(succ)); };
+        auto fingerprint = fingerprints;
+        // Iterate through all successors
+        for (auto &succ : all_successors) //Could have used const iterator
+        {
+            ++statistics.generated;
+            auto succ_fingerprint = *fingerprint++;
+            if (!valid(succ))
+                ++statistics.rejected;
+            else if (!unseen(succ, succ_fingerprint))
+            {
+                ++statistics.deduplicated;
+                reached(succ, false);
+            }
+            // If the state is new, add it (or the end of its deterministic chain) to the store and waiting
+            else
+            {
+                State_t endpoint = compressing ? chain_endpoint(curr_state, succ, is_new, goal_pred) : succ;
+                {
+                    ALLOC_PHASE(alloc_phase_t::trace);
+                    store.insert(endpoint, curr_state, compressing ? state_hash(endpoint) : succ_fingerprint);
+                }
+                {
+                    ALLOC_PHASE(alloc_phase_t::frontier);
+                    scoped_duration_t phase{phase_time(statistics.time.frontier)};
+                    waiting.push_back(endpoint);
+                }
+                reached(endpoint, true);
+            }
+        }
+    }
+
+    // All successors upholding the invariant, regardless of how the generator partitions them
+    std::list<State_t> valid_successors(const State_t &state)
+    {
+        std::list<State_t> result{};
+        auto all_successors = successors_function(state);
+        if constexpr (is_ample_set<decltype(all_successors)>::value)
+        {
+            result.splice(result.end(), all_successors.ample);
+            result.splice(result.end(), all_successors.deferred);
+        }
+        else
+            result.insert(result.end(), all_successors.begin(), all_successors.end());
+        result.remove_if([this](const State_t &succ) { return !invariant(succ); });
+        return result;
+    }
+
+    // The only valid successor of state other than its predecessor, if there is exactly one
+    std::optional<State_t> single_successor(const State_t &predecessor, const State_t &state)
+    {
+        auto succs = valid_successors(state);
+        succs.remove_if([&predecessor](const State_t &succ) { return state_equal{}(succ, predecessor); });
+        if (succs.size() != 1)
+            return std::nullopt;
+        return succs.front();
+    }
+
+    // Follows new single successors from state until a branching, goal, seen or repeated state
+    template <typename Is_new>
+    State_t chain_endpoint(State_t predecessor, State_t state, const Is_new &is_new, const std::function<bool(const State_t &)> &goal_pred)
+    {
+        std::vector<State_t> chain{};
+        while (!goal_pred(state))
+        {
+            auto next = single_successor(predecessor, state);
+            if (!next || !is_new(*next) || std::any_of(chain.begin(), chain.end(), [&](const State_t &seen) { return state_equal{}(seen, *next); }))
+                break;
+            chain.push_back(state);
+            predecessor = std::exchange(state, *next);
+        }
+        return state;
+    }
+
+    // Replays one trace step from a state: the states after it up to the first successor matching the target,
+    // following deterministic chains when they are compressed. Empty if the target cannot be reached.
+    template <typename Matches>
+    std::list<State_t> replay_step(const State_t &from, const Matches &matches)
+    {
+        auto succs = valid_successors(from);
+        auto direct = std::find_if(succs.begin(), succs.end(), matches);
+        if (direct != succs.end())
+            return {*direct};
+        if (!compressing)
+            return {};
+        for (auto &succ : succs)
+        {
+            std::list<State_t> chain{};
+            State_t predecessor{from};
+            std::optional<State_t> state{succ};
+            while (state && !matches(*state) && std::none_of(chain.begin(), chain.end(), [&](const State_t &seen) { return state_equal{}(seen, *state); }))
+            {
+                chain.push_back(*state);
+                auto next = single_successor(predecessor, *state);
+                predecessor = *state;
+                state = next;
+            }
+            if (state && matches(*state))
+            {
+                chain.push_back(*state);
+                return chain;
+            }
+        }
+        return {};
+    }
+
+    state_graph_t<State_t> build_graph()
+    {
+        state_graph_t<State_t> graph{};
+        // The initial states are the first nodes
+        std::map<State_t, std::size_t, state_less> index{};
+        graph.states = initial_states;
+        for (std::size_t i = 0; i < graph.states.size(); ++i)
+            index.emplace(graph.states[i], i);
+        for (std::size_t i = 0; i < graph.states.size(); ++i)
+        {
+            std::vector<std::size_t> edges{};
+            for (auto &succ : valid_successors(graph.states[i]))
+            {
+                auto [found, inserted] = index.emplace(succ, graph.states.size());
+                if (inserted)
+                    graph.states.push_back(std::move(succ));
+                edges.push_back(found->second);
+            }
+            graph.edges.push_back(std::move(edges));
+        }
+        return graph;
+    }
+
+    // Cheapest path from the last node of root to a goal, avoiding the banned nodes and banned edges out of the spur node
+    template <typename C, typename Fold>
+    std::vector<std::size_t> cheapest_path(const state_graph_t<State_t> &graph, const std::vector<bool> &goals, const std::vector<std::size_t> &root,
+                                           const C &root_cost, const Fold &fold, const std::vector<bool> &banned, const std::set<std::size_t> &banned_edges)
+    {
+        auto spur = root.back();
+        std::vector<std::optional<C>> best(graph.states.size());
+        std::vector<std::size_t> parent(graph.states.size());
+        std::vector<bool> closed(graph.states.size());
+        std::multimap<C, std::size_t> open{{root_cost, spur}};
+        best[spur] = root_cost;
+        while (!open.empty())
+        {
+            auto [cost, node] = *open.begin();
+            open.erase(open.begin());
+            if (closed[node] || *best[node] < cost)
+                continue;
+            closed[node] = true;
+            if (goals[node])
+            {
+                std::vector<std::size_t> path{node};
+                while (node != spur)
+                    path.push_back(node = parent[node]);
+                path.insert(path.end(), std::next(root.rbegin()), root.rend());
+                std::reverse(path.begin(), path.end());
+                return path;
+            }
+            for (auto succ : graph.edges[node])
+            {
+                if (banned[succ] || closed[succ] || (node == spur && banned_edges.count(succ)))
+                    continue;
+                auto succ_cost = fold(succ, cost);
+                if (!best[succ] || succ_cost < *best[succ])
+                {
+                    best[succ] = succ_cost;
+                    parent[succ] = node;
+                    open.emplace(succ_cost, succ);
+                }
+            }
+        }
+        return {};
+    }
+
+    template <typename C, typename Fold>
+    std::vector<std::vector<std::size_t>> yen(const state_graph_t<State_t> &graph, const std::vector<bool> &goals, std::size_t k, std::size_t source, const C &start_cost, const Fold &fold)
+    {
+        auto path_cost = [&](const std::vector<std::size_t> &path, std::size_t length) {
+            C cost{start_cost};
+            for (std::size_t i = 1; i < length; ++i)
+                cost = fold(path[i], cost);
+            return cost;
+        };
+        std::vector<std::vector<std::size_t>> shortest{};
+        std::multimap<C, std::vector<std::size_t>> candidates{};
+        auto first = cheapest_path(graph, goals, {source}, start_cost, fold, std::vector<bool>(graph.states.size()), {});
+        if (!first.empty())
+            shortest.push_back(std::move(first));
+        while (!shortest.empty() && shortest.size() < k)
+        {
+            auto &previous = shortest.back();
+            // Deviate from the previous path at every node, keeping its prefix (root) fixed
+            for (std::size_t i = 0; i + 1 < previous.size(); ++i)
+            {
+                std::vector<std::size_t> root(previous.begin(), previous.begin() + i + 1);
+                std::set<std::size_t> banned_edges{};
+                for (auto &path : shortest)
+                    if (path.size() > i + 1 && std::equal(root.begin(), root.end(), path.begin()))
+                        banned_edges.insert(path[i + 1]);
+                std::vector<bool> banned(graph.states.size());
+                for (std::size_t j = 0; j < i; ++j)
+                    banned[root[j]] = true;
+                auto path = cheapest_path(graph, goals, root, path_cost(root, root.size()), fold, banned, banned_edges);
+                if (path.empty())
+                    continue;
+                auto cost = path_cost(path, path.size());
+                auto same = candidates.equal_range(cost);
+                if (std::none_of(same.first, same.second, [&path](auto &candidate) { return candidate.second == path; }))
+                    candidates.emplace(cost, std::move(path));
+            }
+            if (candidates.empty())
+                break;
+            shortest.push_back(std::move(candidates.begin()->second));
+            candidates.erase(candidates.begin());
+        }
+        return shortest;
+    }
+
+    // The reachable graph as far as a search has generated it: states are indexed when first generated, and the valid
+    // successors of a node when first asked for. A node's successors stay valid until those of another node are asked for.
+    class generated_graph_t
+    {
+        state_space_t &space;
+        std::unordered_map<State_t, std::size_t, state_hasher, state_equal> index{};
+        state_graph_t<State_t> graph{};
+        std::vector<bool> generated{};
+
+        std::size_t node(const State_t &state)
+        {
+            auto [found, inserted] = index.emplace(state, graph.states.size());
+            if (inserted)
+            {
+                graph.states.push_back(state);
+                graph.edges.emplace_back();
+                generated.push_back(false);
+            }
+            return found->second;
+        }
+
+    public:
+        explicit generated_graph_t(state_space_t &space) : space{space}
+        {
+            for (auto &state : space.initial_states)
+                node(state);
+        }
+
+        std::size_t size() const noexcept { return graph.size(); }
+        const State_t &state(std::size_t index) const noexcept { return graph.state(index); }
+
+        const std::vector<std::size_t> &successors(std::size_t from)
+        {
+            if (!generated[from])
+            {
+                generated[from] = true;
+                std::vector<std::size_t> edges{};
+                for (auto &succ : space.valid_successors(graph.states[from]))
+                    edges.push_back(node(succ));
+                graph.edges[from] = std::move(edges);
+            }
+            return graph.edges[from];
+        }
+    };
+
+    // Breadth first search of check_all over node indices. The goals of a layer are known before any of it is expanded,
+    // so the search ends at the first layer holding a goal.
+    template <typename Graph_t>
+    solution_dag_t<State_t> check_all_shortest(Graph_t &graph, const std::function<bool(const State_t &)> &goal_pred)
+    {
+        constexpr auto unseen = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> depth(graph.size(), unseen);
+        std::vector<std::vector<std::size_t>> parents(graph.size());
+        std::vector<std::size_t> layer(initial_states.size());
+        std::iota(layer.begin(), layer.end(), std::size_t{0});
+        for (auto root : layer)
+            depth[root] = 0;
+        std::vector<std::size_t> goals{};
+        for (std::size_t d = 0; !layer.empty(); ++d)
+        {
+            std::copy_if(layer.begin(), layer.end(), std::back_inserter(goals), [&](std::size_t node) { return goal_pred(graph.state(node)); });
+            if (!goals.empty())
+                break;
+            std::vector<std::size_t> next_layer{};
+            for (auto node : layer)
+            {
+                auto &succs = graph.successors(node);
+                depth.resize(graph.size(), unseen);
+                parents.resize(graph.size());
+                for (auto succ : succs)
+                {
+                    if (depth[succ] == unseen)
+                    {
+                        depth[succ] = d + 1;
+                        next_layer.push_back(succ);
+                    }
+                    if (depth[succ] == d + 1)
+                        parents[succ].push_back(node);
+                }
+            }
+            layer = std::move(next_layer);
+        }
+        return solution_dag(graph, goals, parents);
+    }
+
+    // Uniform cost search of check_all over node indices, until everything left is more expensive than the optimal solutions
+    template <typename Graph_t>
+    solution_dag_t<State_t> check_all_cheapest(Graph_t &graph, const std::function<bool(const State_t &)> &goal_pred)
+    {
+        auto equal = [](const Cost_t &a, const Cost_t &b) { return !(a < b) && !(b < a); };
+        std::vector<std::vector<std::size_t>> parents(graph.size());
+        std::vector<std::optional<Cost_t>> best(graph.size());
+        std::vector<bool> closed(graph.size());
+        std::multimap<Cost_t, std::size_t> open{};
+        for (std::size_t root = 0; root < initial_states.size(); ++root)
+        {
+            best[root] = initial_cost;
+            open.emplace(initial_cost, root);
+        }
+        std::vector<std::size_t> goals{};
+        std::optional<Cost_t> goal_cost{};
+        while (!open.empty())
+        {
+            auto [cost, node] = *open.begin();
+            open.erase(open.begin());
+            if (goal_cost && *goal_cost < cost)
+                break;
+            if (*best[node] < cost || closed[node])
+                continue; // stale entry
+            closed[node] = true;
+            if (goal_pred(graph.state(node)))
+            {
+                goal_cost = cost;
+                goals.push_back(node);
+                continue;
+            }
+            auto &succs = graph.successors(node);
+            parents.resize(graph.size());
+            best.resize(graph.size());
+            closed.resize(graph.size());
+            for (auto succ : succs)
+            {
+                if (closed[succ])
+                    continue;
+                auto succ_cost = cost_function(graph.state(succ), cost);
+                if (!best[succ] || succ_cost < *best[succ])
+                {
+                    best[succ] = succ_cost;
+                    parents[succ] = {node};
+                    open.emplace(succ_cost, succ);
+                }
+                else if (equal(succ_cost, *best[succ]))
+                    parents[succ].push_back(node);
+            }
+        }
+        return solution_dag(graph, goals, parents);
+    }
+
+    // The solution graph of the optimal parents found over node indices, keeping only the nodes leading to a goal
+    template <typename Graph_t>
+    solution_dag_t<State_t> solution_dag(const Graph_t &graph, const std::vector<std::size_t> &goals, const std::vector<std::vector<std::size_t>> &parents)
+    {
+        std::map<State_t, std::vector<State_t>, state_less> state_parents{};
+        std::vector<State_t> goal_states{};
+        std::vector<bool> added(graph.size());
+        std::vector<std::size_t> work{goals};
+        for (auto goal : goals)
+            goal_states.push_back(graph.state(goal));
+        while (!work.empty())
+        {
+            auto node = work.back();
+            work.pop_back();
+            if (added[node] || parents[node].empty())
+                continue;
+            added[node] = true;
+            auto &entry = state_parents[graph.state(node)];
+            for (auto parent : parents[node])
+            {
+                entry.push_back(graph.state(parent));
+                work.push_back(parent);
+            }
+        }
+        return {initial_states, std::move(goal_states), std::move(state_parents)};
+    }
+
+    // The states in [first, last) without repetitions, in their order
+    template <typename Iterator>
+    static std::vector<State_t> unique_states(Iterator first, Iterator last)
+    {
+        std::vector<State_t> states{};
+        std::unordered_set<State_t, state_hasher, state_equal> seen{};
+        for (; first != last; ++first)
+            if (seen.insert(*first).second)
+                states.push_back(*first);
+        if (states.empty())
+            throw new std::invalid_argument("At least one initial state is needed");
+        return states;
     }
 
-private:
     State_t popstate(std::deque<State_t> &waiting, const search_order_t &search_order)
     {
         State_t state;
@@ -138,17 +1802,34 @@ private:
         return state;
     }
 
-    auto get_solution_from_trace(std::map<State_t, State_t> &trace, State_t &curr_state)
+    auto get_solution_from_trace(const search_store_t<State_t> &store, const State_t &curr_state)
     {
         std::list<State_t> solution{};
-        State_t state{curr_state};
-        solution.push_front(state);
-        // Backtracks the trace from the goal state to the inital state
-        while (!(state == initial_state))
+        if (store.regime() == storage_regime_t::exact)
+        {
+            // Backtracks the trace from the goal state to the inital state
+            auto path = store.state_path(curr_state);
+            if (!compressing)
+                return std::list<State_t>(path.begin(), path.end());
+            solution.push_back(path.front());
+            for (auto i = 1u; i < path.size(); ++i)
+                solution.splice(solution.end(), replay_step(solution.back(), [&](const State_t &state) { return state_equal{}(state, path[i]); }));
+        }
+        else
         {
-            state = trace[curr_state];
-            solution.push_front(state);
-            curr_state = state;
+            // Only fingerprints are known, so replay the transitions from the initial state matching them one by one
+            auto path = store.fingerprint_path(curr_state);
+            auto start = std::find_if(initial_states.begin(), initial_states.end(), [&](const State_t &state) { return state_hash(state) == path.front(); });
+            if (start == initial_states.end())
+                throw new std::logic_error("The trace could not be replayed (fingerprint collision)");
+            solution.push_back(*start);
+            for (auto i = 1u; i < path.size(); ++i)
+            {
+                auto step = replay_step(solution.back(), [&](const State_t &state) { return state_hash(state) == path[i]; });
+                if (step.empty())
+                    throw new std::logic_error("The trace could not be replayed (fingerprint collision)");
+                solution.splice(solution.end(), step);
+            }
         }
         return solution;
     }
@@ -167,6 +1848,18 @@ template <typename State_t, typename Successor_gen>
 state_space_t(const State_t &, const Successor_gen &)
     -> state_space_t<State_t, int, Successor_gen>;
 
+template <typename Iterator, typename Cost_t, typename Successor_gen, typename Invariant_type, typename Cost_fn>
+state_space_t(Iterator, Iterator, const Cost_t &, const Successor_gen &, const Invariant_type &, const Cost_fn &)
+    -> state_space_t<typename std::iterator_traits<Iterator>::value_type, Cost_t, Successor_gen>;
+
+template <typename Iterator, typename Successor_gen, typename Invariant_type>
+state_space_t(Iterator, Iterator, const Successor_gen &, const Invariant_type &)
+    -> state_space_t<typename std::iterator_traits<Iterator>::value_type, int, Successor_gen>;
+
+template <typename Iterator, typename Successor_gen>
+state_space_t(Iterator, Iterator, const Successor_gen &)
+    -> state_space_t<typename std::iterator_traits<Iterator>::value_type, int, Successor_gen>;
+
 //Using variadic template and fold (C++17)
 template <typename... Args>
 void log(Args... args)
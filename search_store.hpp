@@ -0,0 +1,260 @@
+#include "state_hash.hpp"
+#include "state_table.hpp"
+#include "statistics.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef SEARCH_STORE_H // include guards
+#define SEARCH_STORE_H
+
+// Visited states (waiting and passed) of a search with the state each was reached from.
+// Within a memory budget it degrades gracefully: exact states are compacted to 64-bit fingerprints,
+// and fingerprints to a bitstate table, whose paths are only kept for the states still reachable from waiting.
+template <typename State_t>
+class search_store_t
+{
+    using fingerprint_t = std::uint64_t;
+
+    // Parent link of a state discovered in bitstate regime, alive while a descendant is waiting
+    struct node_t
+    {
+        fingerprint_t fingerprint;
+        std::shared_ptr<node_t> parent;
+    };
+
+    storage_regime_t current{storage_regime_t::exact};
+    std::size_t budget;
+    std::size_t state_bytes;
+    std::size_t stored{0};
+    // Exact regime: state -> parent
+    state_table_t<State_t> states{};
+    // Fingerprint regime: fingerprint -> parent fingerprint
+    std::unordered_map<fingerprint_t, fingerprint_t> fingerprints{};
+    // Bitstate regime: sorted (fingerprint, parent) pairs frozen at the switch, the table, and the links of waiting states
+    std::vector<std::pair<fingerprint_t, fingerprint_t>> frozen{};
+    std::vector<std::uint64_t> bits{};
+    std::unordered_map<fingerprint_t, std::shared_ptr<node_t>> waiting_nodes{};
+    std::shared_ptr<node_t> popped{};
+
+    // Rough heap cost of the fingerprint containers: a hash node holds the value and a next pointer,
+    // plus a bucket pointer and the allocator's header
+    static constexpr std::size_t hash_node_overhead = 40;
+
+    std::pair<std::size_t, std::size_t> bit_positions(fingerprint_t fingerprint) const noexcept
+    {
+        auto size = bits.size() * 64;
+        return {fingerprint % size, mix_hash(fingerprint) % size};
+    }
+
+    bool test_bit(std::size_t bit) const noexcept { return (bits[bit / 64] >> (bit % 64)) & 1u; }
+    void set_bit(std::size_t bit) noexcept { bits[bit / 64] |= std::uint64_t{1} << (bit % 64); }
+
+    void to_fingerprints()
+    {
+        for (auto &entry : states)
+            fingerprints.emplace(entry.fingerprint, state_hash(entry.parent));
+        states = state_table_t<State_t>{};
+        current = storage_regime_t::fingerprint;
+    }
+
+    void to_bitstate(std::size_t waiting_bytes)
+    {
+        frozen.assign(fingerprints.begin(), fingerprints.end());
+        decltype(fingerprints){}.swap(fingerprints);
+        std::sort(frozen.begin(), frozen.end());
+        // Half of what is left goes to the table, the rest to waiting and the links of new states
+        auto used = frozen.size() * sizeof(frozen.front()) + waiting_bytes;
+        auto table_bytes = std::max<std::size_t>(budget > used ? (budget - used) / 2 : 0, 64);
+        bits.assign(table_bytes / 8, 0);
+        for (auto &entry : frozen)
+        {
+            auto [first, second] = bit_positions(entry.first);
+            set_bit(first);
+            set_bit(second);
+        }
+        current = storage_regime_t::bitstate;
+    }
+
+public:
+    // The initial states are stored as their own parents
+    search_store_t(const std::vector<State_t> &initial, std::size_t memory_budget)
+        : budget{memory_budget},
+          state_bytes{state_size<State_t>::bytes(initial.front())}
+    {
+        for (auto &state : initial)
+            insert(state, state);
+    }
+
+    storage_regime_t regime() const noexcept { return current; }
+    std::size_t size() const noexcept { return stored; }
+
+    bool contains(const State_t &state) const { return contains(state, state_hash(state)); }
+
+    // As above, with the fingerprint (state_hash) of the state computed by the caller
+    bool contains(const State_t &state, fingerprint_t fingerprint) const
+    {
+        switch (current)
+        {
+        case storage_regime_t::exact:
+            return states.contains(state, fingerprint);
+        case storage_regime_t::fingerprint:
+            return fingerprints.count(fingerprint) != 0;
+        case storage_regime_t::bitstate:
+        {
+            auto [first, second] = bit_positions(fingerprint);
+            return test_bit(first) && test_bit(second);
+        }
+        }
+        return false;
+    }
+
+    // Starts loading what contains and insert will read for the fingerprint into the cache
+    void prefetch(fingerprint_t fingerprint) const noexcept
+    {
+        if (current == storage_regime_t::exact)
+            states.prefetch(fingerprint);
+        else if (current == storage_regime_t::bitstate)
+        {
+            auto [first, second] = bit_positions(fingerprint);
+            prefetch_line(&bits[first / 64]);
+            prefetch_line(&bits[second / 64]);
+        }
+    }
+
+    // Records a newly discovered state and the state it was reached from (in bitstate regime: the last popped state)
+    void insert(const State_t &state, const State_t &parent) { insert(state, parent, state_hash(state)); }
+
+    void insert(const State_t &state, const State_t &parent, fingerprint_t fingerprint)
+    {
+        ++stored;
+        switch (current)
+        {
+        case storage_regime_t::exact:
+            states.insert(state, parent, fingerprint);
+            break;
+        case storage_regime_t::fingerprint:
+            fingerprints.emplace(fingerprint, state_hash(parent));
+            break;
+        case storage_regime_t::bitstate:
+        {
+            auto [first, second] = bit_positions(fingerprint);
+            set_bit(first);
+            set_bit(second);
+            waiting_nodes[fingerprint] = std::make_shared<node_t>(node_t{fingerprint, popped});
+            break;
+        }
+        }
+    }
+
+    // Links a stored state to another state it was reached from, only in exact regime: returns whether it was relinked
+    bool reparent(const State_t &state, const State_t &parent)
+    {
+        if (current != storage_regime_t::exact)
+            return false;
+        states.reparent(state, parent, state_hash(state));
+        return true;
+    }
+
+    // Called for every state taken from waiting, so that its successors can be linked to it in bitstate regime
+    void pop(const State_t &state)
+    {
+        if (current != storage_regime_t::bitstate)
+            return;
+        auto fingerprint = state_hash(state);
+        auto found = waiting_nodes.find(fingerprint);
+        if (found == waiting_nodes.end()) // discovered before the switch, its path continues in the frozen pairs
+            popped = std::make_shared<node_t>(node_t{fingerprint, nullptr});
+        else
+        {
+            popped = std::move(found->second);
+            waiting_nodes.erase(found);
+        }
+    }
+
+    // Estimated bytes used by the store and waiting
+    std::size_t bytes(std::size_t waiting_size) const noexcept
+    {
+        auto waiting_bytes = waiting_size * state_bytes;
+        switch (current)
+        {
+        case storage_regime_t::exact:
+            return states.bytes(state_bytes) + waiting_bytes;
+        case storage_regime_t::fingerprint:
+            return fingerprints.size() * (2 * sizeof(fingerprint_t) + hash_node_overhead) + waiting_bytes;
+        case storage_regime_t::bitstate:
+            // every waiting state owns a node, and about as many ancestors are kept alive
+            return frozen.size() * sizeof(frozen.front()) + bits.size() * sizeof(bits.front()) +
+                   waiting_nodes.size() * (2 * sizeof(node_t) + sizeof(fingerprint_t) + 2 * hash_node_overhead) + waiting_bytes;
+        }
+        return 0;
+    }
+
+    // Switches to a cheaper regime when the estimate reaches three quarters of the budget.
+    // Returns false when even bitstate storage exceeds the budget, and the search must stop.
+    bool fits(std::size_t waiting_size)
+    {
+        if (budget == std::numeric_limits<std::size_t>::max())
+            return true;
+        if (current == storage_regime_t::exact && bytes(waiting_size) >= budget / 4 * 3)
+            to_fingerprints();
+        if (current == storage_regime_t::fingerprint && bytes(waiting_size) >= budget / 4 * 3)
+            to_bitstate(waiting_size * state_bytes);
+        return bytes(waiting_size) < budget;
+    }
+
+    // Number of steps from the initial state to the given state (which must be stored, see fingerprint_path)
+    std::size_t depth(const State_t &state) const
+    {
+        return (current == storage_regime_t::exact ? state_path(state).size() : fingerprint_path(state).size()) - 1;
+    }
+
+    // The states from the initial state to the given state, only available in exact regime
+    std::vector<State_t> state_path(const State_t &state) const
+    {
+        std::vector<State_t> path{state};
+        for (auto parent = &states.parent(state, state_hash(state)); !state_equal{}(path.back(), *parent);
+             parent = &states.parent(path.back(), state_hash(path.back())))
+            path.push_back(*parent);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // The fingerprints from the initial state to the given state (in bitstate regime: the last popped or a waiting state)
+    std::vector<fingerprint_t> fingerprint_path(const State_t &state) const
+    {
+        std::vector<fingerprint_t> path{state_hash(state)};
+        if (current == storage_regime_t::bitstate)
+        {
+            auto found = waiting_nodes.find(path.back());
+            auto node = found != waiting_nodes.end() ? found->second : popped;
+            for (node = node ? node->parent : nullptr; node; node = node->parent)
+                path.push_back(node->fingerprint);
+        }
+        // until an initial state, which is its own parent
+        while (true)
+        {
+            auto parent = path.back();
+            if (current == storage_regime_t::fingerprint)
+                parent = fingerprints.at(path.back());
+            else
+            {
+                auto found = std::lower_bound(frozen.begin(), frozen.end(), std::make_pair(path.back(), fingerprint_t{0}));
+                if (found != frozen.end() && found->first == path.back())
+                    parent = found->second;
+            }
+            if (parent == path.back())
+                break;
+            path.push_back(parent);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+};
+
+#endif //SEARCH_STORE_H
@@ -0,0 +1,168 @@
+#include "cancellation.hpp"
+#include "thread_pool.hpp"
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+#ifndef SEARCH_TASK_H // include guards
+#define SEARCH_TASK_H
+
+// Searches as C++20 coroutines (state_space_t::check_coroutine), interleaved on a thread pool by search_scheduler_t.
+// Only available when compiled as C++20 or later, the rest of the engine stays C++17.
+#if defined(__cpp_impl_coroutine)
+
+template <typename, typename, typename>
+class state_space_t;
+
+// A search suspended between slices of expansions, resumed by search_scheduler_t or by hand
+template <typename Result_t>
+class search_task_t
+{
+public:
+    struct promise_type
+    {
+        std::optional<Result_t> result{};
+        std::exception_ptr error{};
+        std::size_t explored{0};
+
+        search_task_t get_return_object() noexcept { return search_task_t{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(std::size_t expanded) noexcept
+        {
+            explored = expanded;
+            return {};
+        }
+        void return_value(Result_t value) { result = std::move(value); }
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    search_task_t(search_task_t &&other) noexcept
+        : handle{std::exchange(other.handle, {})},
+          token{std::move(other.token)} {}
+    search_task_t &operator=(search_task_t &&other) noexcept
+    {
+        std::swap(handle, other.handle);
+        std::swap(token, other.token);
+        return *this;
+    }
+    ~search_task_t()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    // Runs the search for one more slice, returns false once it has ended
+    bool resume()
+    {
+        if (!handle.done())
+            handle.resume();
+        return !handle.done();
+    }
+
+    bool done() const noexcept { return handle.done(); }
+
+    // States expanded by the end of the last slice
+    std::size_t explored() const noexcept { return handle.promise().explored; }
+
+    // Ends the search with its partial result at its next step
+    void cancel() noexcept { token.cancel(); }
+
+    // The result of an ended search (or the exception it threw)
+    Result_t result()
+    {
+        if (handle.promise().error)
+            std::rethrow_exception(handle.promise().error);
+        return std::move(*handle.promise().result);
+    }
+
+private:
+    explicit search_task_t(std::coroutine_handle<promise_type> handle) noexcept : handle{handle} {}
+
+    std::coroutine_handle<promise_type> handle;
+    cancellation_token_t token{}; // shared with the search, which polls it
+
+    template <typename, typename, typename>
+    friend class state_space_t;
+};
+
+// Limits of one search run by search_scheduler_t, beyond either it is cancelled and returns its partial result
+struct search_budget_t
+{
+    std::size_t expansions{std::numeric_limits<std::size_t>::max()};
+    std::chrono::nanoseconds time{std::chrono::nanoseconds::max()}; // spent running its slices, not waiting for a worker
+};
+
+// Interleaves searches fairly on a thread pool: a search runs one slice, then queues behind the others,
+// so small searches finish quickly however many large ones are running
+class search_scheduler_t
+{
+public:
+    explicit search_scheduler_t(thread_pool_t &pool = search_pool()) noexcept : pool{pool} {}
+
+    template <typename Result_t>
+    std::future<Result_t> submit(search_task_t<Result_t> task, search_budget_t budget = {})
+    {
+        auto job = std::make_shared<job_t<Result_t>>(std::move(task), budget);
+        auto result = job->promise.get_future();
+        schedule(pool, std::move(job));
+        return result;
+    }
+
+private:
+    template <typename Result_t>
+    struct job_t
+    {
+        job_t(search_task_t<Result_t> task, search_budget_t budget) : task{std::move(task)}, budget{budget} {}
+
+        search_task_t<Result_t> task;
+        search_budget_t budget;
+        std::chrono::nanoseconds used{0};
+        std::promise<Result_t> promise{};
+    };
+
+    // Jobs only refer to the pool, so they may outlive the scheduler
+    template <typename Result_t>
+    static void schedule(thread_pool_t &pool, std::shared_ptr<job_t<Result_t>> job)
+    {
+        pool.submit([&pool, job = std::move(job)]() mutable { run(pool, std::move(job)); });
+    }
+
+    template <typename Result_t>
+    static void run(thread_pool_t &pool, std::shared_ptr<job_t<Result_t>> job)
+    {
+        try
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto running = job->task.resume();
+            job->used += std::chrono::steady_clock::now() - start;
+            if (!running)
+            {
+                job->promise.set_value(job->task.result());
+                return;
+            }
+        }
+        catch (...)
+        {
+            job->promise.set_exception(std::current_exception());
+            return;
+        }
+        if (job->task.explored() >= job->budget.expansions || job->used >= job->budget.time)
+            job->task.cancel();
+        schedule(pool, std::move(job));
+    }
+
+    thread_pool_t &pool;
+};
+
+#endif //__cpp_impl_coroutine
+
+#endif //SEARCH_TASK_H
@@ -0,0 +1,167 @@
+#include "reachability.hpp"
+#include "state_codec.hpp"
+#include "state_hash.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifndef SOLUTION_CACHE_H // include guards
+#define SOLUTION_CACHE_H
+
+// Solutions of earlier queries kept in an append-only file, indexed in memory by the hash of the query:
+// model id and version tag, initial states, goal id, search order and cost function id.
+// Goal and cost functions cannot be compared, so the caller names them, and bumps the version tag whenever the model changes
+// (its transitions or invariant), which makes every query of the old version miss.
+template <typename State_t>
+class solution_cache_t
+{
+    // Each record is a header followed by the states, each prefixed by its packed size
+    struct record_t
+    {
+        std::uint32_t magic{0x43535a50}; // "PZSC"
+        std::uint32_t states{0};
+        std::uint64_t key{0};
+        std::uint64_t bytes{0}; // of the states
+    };
+
+    std::string path;
+    std::uint64_t model;
+    std::unordered_map<std::uint64_t, std::uint64_t> index{}; // key -> offset of its latest record
+    std::fstream file{};
+
+    static std::uint64_t combine(std::uint64_t hash, std::uint64_t value) noexcept { return mix_hash(hash ^ value); }
+    static std::uint64_t text_hash(const std::string &text) noexcept { return state_hash(text); }
+
+    // Indexes the complete records, and cuts off a record left incomplete by a crash
+    void scan()
+    {
+        std::ifstream in{path, std::ios::binary};
+        std::uint64_t offset = 0;
+        auto length = std::filesystem::file_size(path);
+        record_t record{};
+        while (offset + sizeof(record) <= length && in.read(reinterpret_cast<char *>(&record), sizeof(record)) &&
+               record.magic == record_t{}.magic && offset + sizeof(record) + record.bytes <= length)
+        {
+            index[record.key] = offset;
+            offset += sizeof(record) + record.bytes;
+            in.seekg(static_cast<std::streamoff>(offset));
+        }
+        in.close();
+        if (offset != length)
+            std::filesystem::resize_file(path, offset);
+    }
+
+public:
+    solution_cache_t(std::string cache_path, const std::string &model_id, const std::string &version)
+        : path{std::move(cache_path)},
+          model{combine(text_hash(model_id), text_hash(version))}
+    {
+        std::ofstream{path, std::ios::binary | std::ios::app};
+        scan();
+        file.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::app);
+        if (!file)
+            throw new std::runtime_error("The solution cache " + path + " could not be opened");
+    }
+
+    std::size_t size() const noexcept { return index.size(); }
+
+    std::uint64_t key(const std::vector<State_t> &initial, const std::string &goal_id, search_order_t search_order, const std::string &cost_id) const noexcept
+    {
+        auto hash = combine(model, state_hash(initial));
+        hash = combine(hash, text_hash(goal_id));
+        hash = combine(hash, static_cast<std::uint64_t>(search_order));
+        return combine(hash, text_hash(cost_id));
+    }
+
+    std::optional<std::list<State_t>> find(std::uint64_t key)
+    {
+        auto found = index.find(key);
+        if (found == index.end())
+            return std::nullopt;
+        record_t record{};
+        file.seekg(static_cast<std::streamoff>(found->second));
+        file.read(reinterpret_cast<char *>(&record), sizeof(record));
+        std::vector<char> bytes(record.bytes);
+        file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file || record.key != key)
+            throw new std::runtime_error("The solution cache " + path + " is corrupt");
+        // The size prefixes must stay within the record and fill it exactly
+        std::list<State_t> solution{};
+        std::size_t at = 0;
+        while (solution.size() < record.states)
+        {
+            std::uint32_t size;
+            if (bytes.size() - at < sizeof(size))
+                throw new std::runtime_error("The solution cache " + path + " is corrupt");
+            std::memcpy(&size, bytes.data() + at, sizeof(size));
+            at += sizeof(size);
+            if (bytes.size() - at < size)
+                throw new std::runtime_error("The solution cache " + path + " is corrupt");
+            try
+            {
+                solution.push_back(state_codec<State_t>::read(bytes.data() + at, size));
+            }
+            catch (const std::length_error *error)
+            {
+                delete error;
+                throw new std::runtime_error("The solution cache " + path + " is corrupt");
+            }
+            at += size;
+        }
+        if (at != bytes.size())
+            throw new std::runtime_error("The solution cache " + path + " is corrupt");
+        return solution;
+    }
+
+    // Appends the solution (durably, flushed before returning) as the answer to the query
+    void insert(std::uint64_t key, const std::list<State_t> &solution)
+    {
+        std::ostringstream states{};
+        for (auto &state : solution)
+        {
+            auto size = static_cast<std::uint32_t>(state_codec<State_t>::size(state));
+            states.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            state_codec<State_t>::write(states, state);
+        }
+        auto bytes = states.str();
+        record_t record{};
+        record.states = static_cast<std::uint32_t>(solution.size());
+        record.key = key;
+        record.bytes = bytes.size();
+        file.seekp(0, std::ios::end);
+        auto offset = static_cast<std::uint64_t>(file.tellp());
+        file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        file.flush();
+        if (!file)
+            throw new std::runtime_error("The solution cache " + path + " could not be written");
+        index[key] = offset;
+    }
+
+    // The solution of the query from the cache, or from space.check (which is then cached). Failed searches are not cached.
+    // Cost guided queries must name the cost function, as their solutions depend on it.
+    template <typename State_space>
+    std::list<State_t> check(State_space &space, const std::function<bool(const State_t &)> &goal_pred, const std::string &goal_id,
+                             const search_order_t &search_order = search_order_t::breadth_first, const std::string &cost_id = "")
+    {
+        if (search_order == search_order_t::cost_guided && cost_id.empty())
+            throw new std::invalid_argument("A cost guided query of the solution cache needs a cost id");
+        auto query = key(space.initial(), goal_id, search_order, cost_id);
+        if (auto solution = find(query))
+            return std::move(*solution);
+        auto solution = space.check(goal_pred, search_order);
+        insert(query, solution);
+        return solution;
+    }
+};
+
+#endif //SOLUTION_CACHE_H
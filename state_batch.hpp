@@ -0,0 +1,120 @@
+#include "state_hash.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define STATE_BATCH_AVX2
+#endif
+
+#ifndef STATE_BATCH_H // include guards
+#define STATE_BATCH_H
+
+// Kernels over batches of states: the fingerprints of many states at once, and the search for a state among a few.
+// Packed states (see is_packed_state_v) are hashed by AVX2 when the CPU has it (detected once at run time),
+// other states and CPUs by a scalar loop, with the same fingerprints as state_hash.
+
+// Whether the AVX2 kernels run on this CPU
+inline bool batch_avx2() noexcept
+{
+#ifdef STATE_BATCH_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// The 8-byte word of a packed state at the given index, the last one padded with zeros (as state_hash reads it).
+// Sizes are constants so that the copies compile to plain loads.
+template <typename T>
+std::uint64_t packed_word(const T &state, std::size_t word) noexcept
+{
+    std::uint64_t value = 0;
+    auto bytes = reinterpret_cast<const unsigned char *>(&state) + word * sizeof(value);
+    if (word < sizeof(T) / sizeof(value))
+        std::memcpy(&value, bytes, sizeof(value));
+    else
+        std::memcpy(&value, bytes, sizeof(T) % sizeof(value));
+    return value;
+}
+
+#ifdef STATE_BATCH_AVX2
+
+// 64-bit product of each lane with a constant, from 32-bit products as AVX2 has no 64-bit multiply
+__attribute__((target("avx2"))) inline __m256i multiply_avx2(__m256i x, __m256i factor, __m256i factor_high) noexcept
+{
+    auto low = _mm256_mul_epu32(x, factor);
+    auto cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), factor), _mm256_mul_epu32(x, factor_high));
+    return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+// mix_hash of 4 lanes
+__attribute__((target("avx2"))) inline __m256i mix_hash_avx2(__m256i x) noexcept
+{
+    const auto factor1 = _mm256_set1_epi64x(static_cast<long long>(0xbf58476d1ce4e5b9ull));
+    const auto factor1_high = _mm256_set1_epi64x(static_cast<long long>(0xbf58476d1ce4e5b9ull >> 32));
+    const auto factor2 = _mm256_set1_epi64x(static_cast<long long>(0x94d049bb133111ebull));
+    const auto factor2_high = _mm256_set1_epi64x(static_cast<long long>(0x94d049bb133111ebull >> 32));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 30));
+    x = multiply_avx2(x, factor1, factor1_high);
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 27));
+    x = multiply_avx2(x, factor2, factor2_high);
+    return _mm256_xor_si256(x, _mm256_srli_epi64(x, 31));
+}
+
+// The same word of 4 states, one per lane
+template <typename T>
+__attribute__((target("avx2"))) __m256i packed_words_avx2(const T *const *states, std::size_t word) noexcept
+{
+    return _mm256_set_epi64x(static_cast<long long>(packed_word(*states[3], word)), static_cast<long long>(packed_word(*states[2], word)),
+                             static_cast<long long>(packed_word(*states[1], word)), static_cast<long long>(packed_word(*states[0], word)));
+}
+
+// state_hash of packed states, 8 at a time in two interleaved vectors of 4 lanes
+template <typename T>
+__attribute__((target("avx2"))) void state_hashes_avx2(const T *const *states, std::size_t count, std::uint64_t *hashes) noexcept
+{
+    constexpr auto words = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    auto i = std::size_t{0};
+    for (; i + 8 <= count; i += 8)
+    {
+        auto first = _mm256_set1_epi64x(static_cast<long long>(0x9e3779b97f4a7c15ull ^ sizeof(T)));
+        auto second = first;
+        for (auto word = std::size_t{0}; word < words; ++word)
+        {
+            first = mix_hash_avx2(_mm256_xor_si256(first, packed_words_avx2(states + i, word)));
+            second = mix_hash_avx2(_mm256_xor_si256(second, packed_words_avx2(states + i + 4, word)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(hashes + i), first);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(hashes + i + 4), second);
+    }
+    for (; i < count; ++i)
+        hashes[i] = state_hash(*states[i]);
+}
+
+#endif //STATE_BATCH_AVX2
+
+// state_hash of each of the states
+template <typename T>
+void state_hashes(const T *const *states, std::size_t count, std::uint64_t *hashes)
+{
+#ifdef STATE_BATCH_AVX2
+    if constexpr (is_packed_state_v<T> && !has_std_hash<T>::value)
+        if (batch_avx2())
+            return state_hashes_avx2(states, count, hashes);
+#endif
+    for (auto i = std::size_t{0}; i < count; ++i)
+        hashes[i] = state_hash(*states[i]);
+}
+
+// Index of the first of the states equal to target (by state_equal), count if there is none.
+// Scalar: a memcmp of a packed state mostly stops at its first word, which AVX2 compares did not beat on a few states.
+template <typename T>
+std::size_t find_state(const T *states, std::size_t count, const T &target)
+{
+    return std::find_if(states, states + count, [&target](const T &state) { return state_equal{}(state, target); }) - states;
+}
+
+#endif //STATE_BATCH_H
@@ -0,0 +1,50 @@
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifndef STATE_CODEC_H // include guards
+#define STATE_CODEC_H
+
+// How states are packed into files (graph files, the solution cache): trivially copyable states by their object representation,
+// contiguous containers (e.g. std::vector) of trivially copyable elements by their elements. Specialise for other types.
+// read throws if the size of the packed bytes cannot be a state's, e.g. in a corrupt file.
+template <typename State_t, typename = void>
+struct state_codec
+{
+    static_assert(std::is_trivially_copyable_v<State_t>, "Specialise state_codec to store this state type in a file");
+
+    static std::size_t size(const State_t &) noexcept { return sizeof(State_t); }
+    static void write(std::ostream &out, const State_t &state) { out.write(reinterpret_cast<const char *>(&state), sizeof(State_t)); }
+    static State_t read(const char *bytes, std::size_t size)
+    {
+        if (size != sizeof(State_t))
+            throw new std::length_error("The packed state has the wrong size");
+        State_t state;
+        std::memcpy(&state, bytes, sizeof(State_t));
+        return state;
+    }
+};
+
+template <typename State_t>
+struct state_codec<State_t, std::enable_if_t<!std::is_trivially_copyable_v<State_t>,
+                                             std::void_t<decltype(std::declval<const State_t &>().data()), typename State_t::value_type>>>
+{
+    using element_t = typename State_t::value_type;
+    static_assert(std::is_trivially_copyable_v<element_t>, "Specialise state_codec to store this state type in a file");
+
+    static std::size_t size(const State_t &state) noexcept { return state.size() * sizeof(element_t); }
+    static void write(std::ostream &out, const State_t &state) { out.write(reinterpret_cast<const char *>(state.data()), size(state)); }
+    static State_t read(const char *bytes, std::size_t size)
+    {
+        if (size % sizeof(element_t) != 0)
+            throw new std::length_error("The packed state has the wrong size");
+        State_t state(size / sizeof(element_t));
+        std::memcpy(state.data(), bytes, size);
+        return state;
+    }
+};
+
+#endif //STATE_CODEC_H
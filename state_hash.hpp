@@ -0,0 +1,130 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#ifndef STATE_HASH_H // include guards
+#define STATE_HASH_H
+
+// Finalizer of splitmix64: spreads every input bit over the whole 64-bit result
+constexpr std::uint64_t mix_hash(std::uint64_t x) noexcept
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+template <typename T, typename = void>
+struct has_std_hash : std::false_type
+{
+};
+
+template <typename T>
+struct has_std_hash<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T &>()))>> : std::true_type
+{
+};
+
+template <typename T, typename = void>
+struct is_iterable : std::false_type
+{
+};
+
+template <typename T>
+struct is_iterable<T, std::void_t<decltype(std::begin(std::declval<const T &>())), decltype(std::end(std::declval<const T &>()))>> : std::true_type
+{
+};
+
+template <typename T, typename = void>
+struct has_less : std::false_type
+{
+};
+
+template <typename T>
+struct has_less<T, std::void_t<decltype(std::declval<const T &>() < std::declval<const T &>())>> : std::true_type
+{
+};
+
+// A state whose value is its bytes: trivially copyable and without padding (e.g. aggregates of integers and enums,
+// std::array of them). Such states are hashed, compared and ordered by their object representation,
+// so a model needs neither std::hash, operator== nor operator< for them.
+template <typename T>
+constexpr bool is_packed_state_v = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>;
+
+// 64-bit hash of a state, used as its fingerprint: std::hash if the type has one,
+// 8 bytes at a time for packed states, and element by element for other containers
+template <typename T>
+std::uint64_t state_hash(const T &value) noexcept
+{
+    if constexpr (has_std_hash<T>::value)
+        return mix_hash(std::hash<T>{}(value));
+    else if constexpr (is_packed_state_v<T>)
+    {
+        auto bytes = reinterpret_cast<const unsigned char *>(&value);
+        std::uint64_t hash = 0x9e3779b97f4a7c15ull ^ sizeof(T);
+        auto offset = std::size_t{0};
+        for (; offset + sizeof(std::uint64_t) <= sizeof(T); offset += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + offset, sizeof(word));
+            hash = mix_hash(hash ^ word);
+        }
+        if (offset < sizeof(T))
+        {
+            std::uint64_t word = 0;
+            std::memcpy(&word, bytes + offset, sizeof(T) - offset);
+            hash = mix_hash(hash ^ word);
+        }
+        return hash;
+    }
+    else
+    {
+        static_assert(is_iterable<T>::value, "States must be hashable: specialise std::hash for the state type");
+        std::uint64_t hash = 0x9e3779b97f4a7c15ull;
+        for (auto &element : value)
+            hash = mix_hash(hash ^ state_hash(element));
+        return hash;
+    }
+}
+
+// Hash functor for unordered containers of states
+struct state_hasher
+{
+    template <typename T>
+    std::size_t operator()(const T &value) const noexcept { return static_cast<std::size_t>(state_hash(value)); }
+};
+
+// Equality of states: memcmp for packed states, operator== otherwise
+struct state_equal
+{
+    template <typename T>
+    bool operator()(const T &a, const T &b) const
+    {
+        if constexpr (is_packed_state_v<T>)
+            return std::memcmp(&a, &b, sizeof(T)) == 0;
+        else
+            return a == b;
+    }
+};
+
+// Strict weak order of states for ordered containers: operator< if the type has one, memcmp for packed states otherwise
+struct state_less
+{
+    template <typename T>
+    bool operator()(const T &a, const T &b) const
+    {
+        if constexpr (has_less<T>::value)
+            return a < b;
+        else
+        {
+            static_assert(is_packed_state_v<T>, "States must be ordered: define operator< for the state type");
+            return std::memcmp(&a, &b, sizeof(T)) < 0;
+        }
+    }
+};
+
+#endif //STATE_HASH_H
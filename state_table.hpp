@@ -0,0 +1,121 @@
+#include "state_hash.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#ifndef STATE_TABLE_H // include guards
+#define STATE_TABLE_H
+
+// Hints the CPU to start loading the cache line of the address
+inline void prefetch_line(const void *address) noexcept
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    static_cast<void>(address);
+#endif
+}
+
+// Hash table from states to the states they were reached from, probed with fingerprints computed by the caller,
+// e.g. for a whole batch of states at once (see state_batch.hpp). The entries are kept in insertion order, and the
+// open-addressed slots hold only the upper half of the fingerprint and the index of the entry, 8 bytes each.
+template <typename State_t>
+class state_table_t
+{
+public:
+    using fingerprint_t = std::uint64_t;
+
+    struct entry_t
+    {
+        fingerprint_t fingerprint;
+        State_t state;
+        State_t parent;
+    };
+
+private:
+    struct slot_t
+    {
+        std::uint32_t tag;   // upper half of the fingerprint
+        std::uint32_t entry; // index of the entry plus one, 0 if the slot is free
+    };
+
+    std::vector<entry_t> entries{};
+    std::vector<slot_t> slots = std::vector<slot_t>(16);
+
+    static std::uint32_t tag(fingerprint_t fingerprint) noexcept { return static_cast<std::uint32_t>(fingerprint >> 32); }
+    std::size_t mask() const noexcept { return slots.size() - 1; }
+
+    // The slot holding the state, or the free slot where it belongs (linear probing)
+    std::size_t probe(const State_t &state, fingerprint_t fingerprint) const
+    {
+        for (auto slot = fingerprint & mask();; slot = (slot + 1) & mask())
+        {
+            auto &found = slots[slot];
+            if (found.entry == 0 || (found.tag == tag(fingerprint) && state_equal{}(entries[found.entry - 1].state, state)))
+                return slot;
+        }
+    }
+
+    // Doubles the slots, keeping at most half of them used
+    void grow()
+    {
+        std::vector<slot_t>(slots.size() * 2).swap(slots);
+        for (auto i = std::size_t{0}; i < entries.size(); ++i)
+        {
+            auto slot = entries[i].fingerprint & mask();
+            while (slots[slot].entry != 0)
+                slot = (slot + 1) & mask();
+            slots[slot] = slot_t{tag(entries[i].fingerprint), static_cast<std::uint32_t>(i + 1)};
+        }
+    }
+
+public:
+    std::size_t size() const noexcept { return entries.size(); }
+    auto begin() const noexcept { return entries.begin(); }
+    auto end() const noexcept { return entries.end(); }
+
+    // Estimated bytes, given the bytes owned by one state
+    std::size_t bytes(std::size_t state_bytes) const noexcept
+    {
+        return entries.size() * (sizeof(fingerprint_t) + 2 * state_bytes) + slots.size() * sizeof(slot_t);
+    }
+
+    // Starts loading the first slot probed for the fingerprint into the cache
+    void prefetch(fingerprint_t fingerprint) const noexcept { prefetch_line(&slots[fingerprint & mask()]); }
+
+    bool contains(const State_t &state, fingerprint_t fingerprint) const { return slots[probe(state, fingerprint)].entry != 0; }
+
+    // Stores the state with its parent unless it is stored already, returns whether it was stored
+    bool insert(const State_t &state, const State_t &parent, fingerprint_t fingerprint)
+    {
+        if (2 * (entries.size() + 1) > slots.size())
+            grow();
+        auto slot = probe(state, fingerprint);
+        if (slots[slot].entry != 0)
+            return false;
+        entries.push_back(entry_t{fingerprint, state, parent});
+        slots[slot] = slot_t{tag(fingerprint), static_cast<std::uint32_t>(entries.size())};
+        return true;
+    }
+
+    // Links a stored state to another state it was reached from, e.g. by a cheaper path
+    void reparent(const State_t &state, const State_t &parent, fingerprint_t fingerprint)
+    {
+        auto slot = probe(state, fingerprint);
+        if (slots[slot].entry == 0)
+            throw new std::logic_error("The state is not stored");
+        entries[slots[slot].entry - 1].parent = parent;
+    }
+
+    // The state a stored state was reached from
+    const State_t &parent(const State_t &state, fingerprint_t fingerprint) const
+    {
+        auto slot = probe(state, fingerprint);
+        if (slots[slot].entry == 0)
+            throw new std::logic_error("The state is not stored");
+        return entries[slots[slot].entry - 1].parent;
+    }
+};
+
+#endif //STATE_TABLE_H
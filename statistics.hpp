@@ -0,0 +1,171 @@
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+#ifndef STATISTICS_H // include guards
+#define STATISTICS_H
+
+// Wall time spent in each phase of a search. Generation, invariant, dedup and frontier are timed around every state,
+// which costs two clock reads each, so they stay 0 unless the search times its phases (state_space_t::time_phases).
+struct search_phases_t
+{
+    std::chrono::nanoseconds generation{0}; // computing successors
+    std::chrono::nanoseconds invariant{0};  // evaluating the invariant on successors
+    std::chrono::nanoseconds dedup{0};      // looking up successors in waiting and passed
+    std::chrono::nanoseconds frontier{0};   // popping from and pushing to waiting
+    std::chrono::nanoseconds trace{0};      // reconstructing the solution from the trace
+    std::chrono::nanoseconds total{0};
+};
+
+// Hardware events counted during a search (see perf_counters.hpp), -1 if not measured or not available
+struct hardware_counters_t
+{
+    long long cycles{-1};
+    long long instructions{-1};
+    long long cache_misses{-1};
+    long long branch_misses{-1};
+    long long dtlb_misses{-1};
+    double running{-1}; // fraction of the search the events were counted, the counts are scaled up from it
+};
+
+// Engine phases to which heap allocations are attributed (see alloc_tracker.hpp)
+enum class alloc_phase_t
+{
+    other,       // everything not attributed below, e.g. copies of popped states
+    transitions, // the transition list (and its std::function closures) returned by the model
+    successors,  // building the successor list from the transitions
+    frontier,    // growing waiting
+    trace,       // growing the store of visited states and their parents
+    count
+};
+
+constexpr const char *alloc_phase_names[] = {"other", "transitions", "successors", "frontier", "trace"};
+
+// Heap allocations per phase, only counted when built with ALLOC_TRACKING
+struct allocation_counters_t
+{
+    std::size_t allocations[static_cast<std::size_t>(alloc_phase_t::count)]{};
+    std::size_t bytes[static_cast<std::size_t>(alloc_phase_t::count)]{};
+    std::size_t deallocations[static_cast<std::size_t>(alloc_phase_t::count)]{};
+};
+
+// How a search stores its visited states, from the most to the least precise (see search_store.hpp)
+enum class storage_regime_t
+{
+    exact,       // full states
+    fingerprint, // 64-bit hashes of states, a collision may prune a state
+    bitstate     // bits of a hash table, collisions prune states and the search becomes incomplete
+};
+
+constexpr const char *storage_regime_names[] = {"exact", "fingerprint", "bitstate"};
+
+// Counters describing one call to state_space_t::check
+struct search_statistics_t
+{
+    std::size_t generated{0};    // successors computed
+    std::size_t expanded{0};     // states whose successors were computed
+    std::size_t deduplicated{0}; // successors dropped because they were already waiting or passed
+    std::size_t rejected{0};     // successors dropped by the invariant
+    std::size_t peak_frontier{0};
+    std::size_t peak_visited{0};
+    std::size_t bytes_per_state{0}; // estimated memory per visited state, including its trace entry
+    storage_regime_t regime{storage_regime_t::exact}; // storage the search ended in
+    bool complete{true};                             // false if states may have been skipped (not exact or memory budget exhausted)
+    search_phases_t time{};
+    hardware_counters_t hardware{};
+    allocation_counters_t allocations{};
+};
+
+// Adds the lifetime of the scope to a duration (RAII), without reading the clock if the duration is null
+class scoped_duration_t
+{
+public:
+    explicit scoped_duration_t(std::chrono::nanoseconds &duration) noexcept
+        : scoped_duration_t{&duration} {}
+    explicit scoped_duration_t(std::chrono::nanoseconds *duration) noexcept
+        : total{duration},
+          start{duration ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}} {}
+    ~scoped_duration_t()
+    {
+        if (total)
+            *total += std::chrono::steady_clock::now() - start;
+    }
+
+    scoped_duration_t(const scoped_duration_t &) = delete;
+    scoped_duration_t &operator=(const scoped_duration_t &) = delete;
+
+private:
+    std::chrono::nanoseconds *total;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Estimated bytes owned by a state: the object itself plus the heap buffer of contiguous containers
+template <typename State_t, typename = void>
+struct state_size
+{
+    static std::size_t bytes(const State_t &) { return sizeof(State_t); }
+};
+
+template <typename State_t>
+struct state_size<State_t, std::void_t<decltype(std::declval<const State_t &>().capacity()), typename State_t::value_type>>
+{
+    static std::size_t bytes(const State_t &state) { return sizeof(State_t) + state.capacity() * sizeof(typename State_t::value_type); }
+};
+
+// Writes a hardware event total and its value per expanded state as JSON members, null if not available
+inline void write_event(std::ostream &stream, const char *name, long long value, std::size_t expanded)
+{
+    stream << ",\"" << name << "\":";
+    if (value < 0)
+        stream << "null,\"" << name << "_per_state\":null";
+    else
+        stream << value << ",\"" << name << "_per_state\":" << (expanded ? static_cast<double>(value) / expanded : 0.0);
+}
+
+// Writes the statistics as a single JSON object (times in nanoseconds)
+inline std::ostream &operator<<(std::ostream &stream, const search_statistics_t &statistics)
+{
+    const auto &time = statistics.time;
+    const auto &hardware = statistics.hardware;
+    stream << "{\"generated\":" << statistics.generated
+                  << ",\"expanded\":" << statistics.expanded
+                  << ",\"deduplicated\":" << statistics.deduplicated
+                  << ",\"rejected\":" << statistics.rejected
+                  << ",\"peak_frontier\":" << statistics.peak_frontier
+                  << ",\"peak_visited\":" << statistics.peak_visited
+                  << ",\"bytes_per_state\":" << statistics.bytes_per_state
+                  << ",\"regime\":\"" << storage_regime_names[static_cast<int>(statistics.regime)] << "\""
+                  << ",\"complete\":" << (statistics.complete ? "true" : "false")
+                  << ",\"time_ns\":{\"generation\":" << time.generation.count()
+                  << ",\"invariant\":" << time.invariant.count()
+                  << ",\"dedup\":" << time.dedup.count()
+                  << ",\"frontier\":" << time.frontier.count()
+                  << ",\"trace\":" << time.trace.count()
+                  << ",\"total\":" << time.total.count() << "}";
+    if (hardware.cycles >= 0 || hardware.instructions >= 0 || hardware.cache_misses >= 0 || hardware.branch_misses >= 0 || hardware.dtlb_misses >= 0)
+    {
+        stream << ",\"hardware\":{\"events\":\"user\",\"running\":" << hardware.running;
+        write_event(stream, "cycles", hardware.cycles, statistics.expanded);
+        write_event(stream, "instructions", hardware.instructions, statistics.expanded);
+        write_event(stream, "cache_misses", hardware.cache_misses, statistics.expanded);
+        write_event(stream, "branch_misses", hardware.branch_misses, statistics.expanded);
+        write_event(stream, "dtlb_misses", hardware.dtlb_misses, statistics.expanded);
+        stream << "}";
+    }
+    std::size_t total_allocations = 0;
+    for (auto count : statistics.allocations.allocations)
+        total_allocations += count;
+    if (total_allocations > 0)
+    {
+        stream << ",\"allocations\":{\"per_state\":" << (statistics.expanded ? static_cast<double>(total_allocations) / statistics.expanded : 0.0);
+        for (auto i = 0u; i < static_cast<std::size_t>(alloc_phase_t::count); ++i)
+            stream << ",\"" << alloc_phase_names[i] << "\":{\"count\":" << statistics.allocations.allocations[i]
+                   << ",\"bytes\":" << statistics.allocations.bytes[i]
+                   << ",\"deallocations\":" << statistics.allocations.deallocations[i] << "}";
+        stream << "}";
+    }
+    return stream << "}";
+}
+
+#endif //STATISTICS_H
@@ -0,0 +1,97 @@
+#include "profiler.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef THREAD_POOL_H // include guards
+#define THREAD_POOL_H
+
+// Fixed set of worker threads running submitted tasks in submission order
+class thread_pool_t
+{
+public:
+    explicit thread_pool_t(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+    {
+#ifdef PROFILING
+        // The profiler's registry must exist before the pool: a static pool is destroyed (and its workers hand over
+        // their profiles) only after everything constructed after it
+        profiler::registry();
+#endif
+        for (auto i = 0u; i < threads; ++i)
+            workers.emplace_back([this] { work(); });
+    }
+
+    // Finishes the queued tasks before joining the workers
+    ~thread_pool_t()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    thread_pool_t(const thread_pool_t &) = delete;
+    thread_pool_t &operator=(const thread_pool_t &) = delete;
+
+    std::size_t size() const noexcept { return workers.size(); }
+
+    // Queues the task, the future holds its result or the exception it threw
+    template <typename Task>
+    auto submit(Task &&task) -> std::future<std::invoke_result_t<std::decay_t<Task>>>
+    {
+        using Result_t = std::invoke_result_t<std::decay_t<Task>>;
+        // std::function needs a copyable target, so the packaged task is shared
+        auto packaged = std::make_shared<std::packaged_task<Result_t()>>(std::forward<Task>(task));
+        auto result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            tasks.emplace_back([packaged] { (*packaged)(); });
+        }
+        wake.notify_one();
+        return result;
+    }
+
+private:
+    void work()
+    {
+        while (true)
+        {
+            std::function<void()> task{};
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex{};
+    std::condition_variable wake{};
+    std::deque<std::function<void()>> tasks{};
+    bool stopping{false};
+    std::vector<std::thread> workers{};
+};
+
+// The pool owned by the engine, shared by all asynchronous searches and started on first use
+inline thread_pool_t &search_pool()
+{
+    static thread_pool_t pool{};
+    return pool;
+}
+
+#endif //THREAD_POOL_H